@@ -0,0 +1,126 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "o_serialize/ini.h"
+#include "o_serialize/json.h"
+#include "o_serialize/xml.h"
+#include "payloads.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace Bench {
+
+struct Options
+{
+    bool        perf = false;       // collect hardware counters
+    double      minSeconds = 0.2;   // measuring time per case
+    std::string filter;             // run only cases whose "format/shape" contains this
+};
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Number of iterations of op that take about options.minSeconds
+template <typename Op>
+long calibrate(const Options& options, Op& op)
+{
+    long   iterations = 1;
+    double elapsed = 0;
+    for (;;) {
+        const Clock::time_point start = Clock::now();
+        for (long i = 0; i < iterations; ++i) op();
+        elapsed = seconds_since(start);
+        if (elapsed >= options.minSeconds / 10 || iterations >= (1L << 30)) break;
+        iterations *= 2;
+    }
+    return std::max(1L, static_cast<long>(iterations * (options.minSeconds / std::max(elapsed, 1e-9))));
+}
+
+// Keeps the compiler from discarding a result
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// --- Formats under test ---
+
+struct JsonFormat
+{
+    static const char* name() { return "json"; }
+
+    template <typename T>
+    static std::string encode(const T& value) { return OSerialize::JSON::obj_to_string(value); }
+
+    template <typename T>
+    static bool decode(const std::string& text, T& value)
+    {
+        value = OSerialize::JSON::string_to_obj<T>(text);
+        return true;
+    }
+};
+
+struct XmlFormat
+{
+    static const char* name() { return "xml"; }
+
+    template <typename T>
+    static std::string encode(const T& value)
+    {
+        return OSerialize::XML::stringify(value, "root", OSerialize::WriteOptions::compact());
+    }
+
+    template <typename T>
+    static bool decode(const std::string& text, T& value) { return OSerialize::XML::try_parse(text, value); }
+};
+
+struct IniFormat
+{
+    static const char* name() { return "ini"; }
+
+    template <typename T>
+    static std::string encode(const T& value) { return OSerialize::INI::stringify(value); }
+
+    template <typename T>
+    static bool decode(const std::string& text, T& value) { return OSerialize::INI::try_parse(text, value); }
+};
+
+// Calls fn(format, shapeName, value) for every format and payload shape
+template <typename Fn>
+void for_each_case(const Options& options, Fn&& fn)
+{
+    const Flat               flat = make_flat(1);
+    const Order              order = make_order(1, 20);
+    const std::vector<int>   ints = make_ints(10000);
+    const std::vector<Order> orders = make_orders(200);
+    const std::vector<Order> generated = make_generated_orders(200);
+
+    auto run = [&](auto format) {
+        auto one = [&](const char* shape, const auto& value) {
+            const std::string id = std::string(format.name()) + "/" + shape;
+            if (id.find(options.filter) != std::string::npos) fn(format, shape, value);
+        };
+        one("flat", flat);
+        one("order", order);
+        one("ints", ints);
+        one("orders", orders);
+        one("generated", generated);
+    };
+    run(JsonFormat());
+    run(XmlFormat());
+    run(IniFormat());
+}
+
+} // namespace Bench
+
+#endif // BENCH_COMMON_H
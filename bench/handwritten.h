@@ -0,0 +1,309 @@
+#ifndef BENCH_HANDWRITTEN_H
+#define BENCH_HANDWRITTEN_H
+
+#include "payloads.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "tinyxml/tinyxml2.h"
+#include <cstdlib>
+#include <string>
+
+// Hand-coded rapidjson and tinyxml2 codecs for the benchmark payloads, written
+// the way one would without the reflection layer. They produce and accept the
+// same documents as OSerialize::JSON / OSerialize::XML (compact), so the overhead
+// suite compares equal work.
+namespace Bench {
+
+namespace Handwritten {
+
+// --- JSON: rapidjson::Writer out, rapidjson::Document in ---
+
+template <typename Writer>
+void write_json(Writer& w, const Flat& f)
+{
+    w.StartObject();
+    w.Key("id");
+    w.Int(f.id);
+    w.Key("price");
+    w.Double(f.price);
+    w.Key("active");
+    w.Bool(f.active);
+    w.Key("name");
+    w.String(f.name.data(), static_cast<rapidjson::SizeType>(f.name.size()));
+    w.EndObject();
+}
+
+template <typename Writer>
+void write_json(Writer& w, const Order& o)
+{
+    w.StartObject();
+    w.Key("id");
+    w.Int(o.id);
+    w.Key("customer");
+    w.String(o.customer.data(), static_cast<rapidjson::SizeType>(o.customer.size()));
+    w.Key("meta");
+    write_json(w, o.meta);
+    w.Key("items");
+    w.StartArray();
+    for (const Item& item : o.items) {
+        w.StartObject();
+        w.Key("sku");
+        w.Int(item.sku);
+        w.Key("qty");
+        w.Int(item.qty);
+        w.Key("price");
+        w.Double(item.price);
+        w.Key("title");
+        w.String(item.title.data(), static_cast<rapidjson::SizeType>(item.title.size()));
+        w.EndObject();
+    }
+    w.EndArray();
+    w.Key("tags");
+    w.StartObject();
+    for (const auto& tag : o.tags) {
+        w.Key(tag.first.data(), static_cast<rapidjson::SizeType>(tag.first.size()));
+        w.String(tag.second.data(), static_cast<rapidjson::SizeType>(tag.second.size()));
+    }
+    w.EndObject();
+    w.EndObject();
+}
+
+template <typename T>
+std::string to_json(const T& value)
+{
+    rapidjson::StringBuffer                    buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    write_json(writer, value);
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+template <typename T>
+std::string to_json(const std::vector<T>& values)
+{
+    rapidjson::StringBuffer                    buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartArray();
+    for (const T& value : values) write_json(writer, value);
+    writer.EndArray();
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+inline std::string get_string(const rapidjson::Value& v, const char* key)
+{
+    auto it = v.FindMember(key);
+    return it != v.MemberEnd() && it->value.IsString()
+               ? std::string(it->value.GetString(), it->value.GetStringLength())
+               : std::string();
+}
+
+inline void read_json(const rapidjson::Value& v, Flat& f)
+{
+    f.id = v["id"].GetInt();
+    f.price = v["price"].GetDouble();
+    f.active = v["active"].GetBool();
+    f.name = get_string(v, "name");
+}
+
+inline void read_json(const rapidjson::Value& v, Order& o)
+{
+    o.id = v["id"].GetInt();
+    o.customer = get_string(v, "customer");
+    read_json(v["meta"], o.meta);
+    o.items.clear();
+    for (const auto& e : v["items"].GetArray()) {
+        Item item;
+        item.sku = e["sku"].GetInt();
+        item.qty = e["qty"].GetInt();
+        item.price = e["price"].GetDouble();
+        item.title = get_string(e, "title");
+        o.items.push_back(std::move(item));
+    }
+    o.tags.clear();
+    for (const auto& m : v["tags"].GetObject()) {
+        o.tags[std::string(m.name.GetString(), m.name.GetStringLength())] =
+            std::string(m.value.GetString(), m.value.GetStringLength());
+    }
+}
+
+template <typename T>
+bool from_json(const std::string& text, T& value)
+{
+    rapidjson::Document doc;
+    doc.Parse(text.data(), text.size());
+    if (doc.HasParseError()) return false;
+    read_json(doc, value);
+    return true;
+}
+
+template <typename T>
+bool from_json(const std::string& text, std::vector<T>& values)
+{
+    rapidjson::Document doc;
+    doc.Parse(text.data(), text.size());
+    if (doc.HasParseError() || !doc.IsArray()) return false;
+    values.clear();
+    for (const auto& e : doc.GetArray()) {
+        T value;
+        read_json(e, value);
+        values.push_back(std::move(value));
+    }
+    return true;
+}
+
+// --- XML: tinyxml2::XMLPrinter out, tinyxml2::XMLDocument in ---
+
+inline void text_element(tinyxml2::XMLPrinter& p, const char* name, const std::string& text)
+{
+    p.OpenElement(name, true);
+    p.PushText(text.c_str());
+    p.CloseElement(true);
+}
+
+template <typename V>
+void number_element(tinyxml2::XMLPrinter& p, const char* name, V value)
+{
+    p.OpenElement(name, true);
+    p.PushText(value);
+    p.CloseElement(true);
+}
+
+inline void write_xml(tinyxml2::XMLPrinter& p, const Flat& f)
+{
+    number_element(p, "id", f.id);
+    number_element(p, "price", f.price);
+    number_element(p, "active", f.active);
+    text_element(p, "name", f.name);
+}
+
+inline void write_xml(tinyxml2::XMLPrinter& p, const Order& o)
+{
+    number_element(p, "id", o.id);
+    text_element(p, "customer", o.customer);
+    p.OpenElement("meta", true);
+    write_xml(p, o.meta);
+    p.CloseElement(true);
+    p.OpenElement("items", true);
+    for (const Item& item : o.items) {
+        p.OpenElement("item", true);
+        number_element(p, "sku", item.sku);
+        number_element(p, "qty", item.qty);
+        number_element(p, "price", item.price);
+        text_element(p, "title", item.title);
+        p.CloseElement(true);
+    }
+    p.CloseElement(true);
+    p.OpenElement("tags", true);
+    for (const auto& tag : o.tags) text_element(p, tag.first.c_str(), tag.second);
+    p.CloseElement(true);
+}
+
+template <typename T>
+std::string to_xml(const T& value)
+{
+    tinyxml2::XMLPrinter printer(nullptr, true);
+    printer.OpenElement("root", true);
+    write_xml(printer, value);
+    printer.CloseElement(true);
+    return std::string(printer.CStr(), printer.CStrSize() - 1);
+}
+
+template <typename T>
+std::string to_xml(const std::vector<T>& values)
+{
+    tinyxml2::XMLPrinter printer(nullptr, true);
+    printer.OpenElement("root", true);
+    for (const T& value : values) {
+        printer.OpenElement("item", true);
+        write_xml(printer, value);
+        printer.CloseElement(true);
+    }
+    printer.CloseElement(true);
+    return std::string(printer.CStr(), printer.CStrSize() - 1);
+}
+
+inline std::string child_text(const tinyxml2::XMLElement* e, const char* name)
+{
+    const tinyxml2::XMLElement* child = e->FirstChildElement(name);
+    const char*                 text = child ? child->GetText() : nullptr;
+    return text ? std::string(text) : std::string();
+}
+
+inline int child_int(const tinyxml2::XMLElement* e, const char* name)
+{
+    const tinyxml2::XMLElement* child = e->FirstChildElement(name);
+    return child ? child->IntText() : 0;
+}
+
+inline double child_double(const tinyxml2::XMLElement* e, const char* name)
+{
+    const tinyxml2::XMLElement* child = e->FirstChildElement(name);
+    return child ? child->DoubleText() : 0;
+}
+
+inline void read_xml(const tinyxml2::XMLElement* e, Flat& f)
+{
+    f.id = child_int(e, "id");
+    f.price = child_double(e, "price");
+    const tinyxml2::XMLElement* active = e->FirstChildElement("active");
+    f.active = active && active->BoolText();
+    f.name = child_text(e, "name");
+}
+
+inline void read_xml(const tinyxml2::XMLElement* e, Order& o)
+{
+    o.id = child_int(e, "id");
+    o.customer = child_text(e, "customer");
+    if (const tinyxml2::XMLElement* meta = e->FirstChildElement("meta")) read_xml(meta, o.meta);
+    o.items.clear();
+    if (const tinyxml2::XMLElement* items = e->FirstChildElement("items")) {
+        for (const tinyxml2::XMLElement* it = items->FirstChildElement("item"); it; it = it->NextSiblingElement("item")) {
+            Item item;
+            item.sku = child_int(it, "sku");
+            item.qty = child_int(it, "qty");
+            item.price = child_double(it, "price");
+            item.title = child_text(it, "title");
+            o.items.push_back(std::move(item));
+        }
+    }
+    o.tags.clear();
+    if (const tinyxml2::XMLElement* tags = e->FirstChildElement("tags")) {
+        for (const tinyxml2::XMLElement* t = tags->FirstChildElement(); t; t = t->NextSiblingElement()) {
+            const char* text = t->GetText();
+            o.tags[t->Name()] = text ? text : "";
+        }
+    }
+}
+
+template <typename T>
+bool from_xml(const std::string& text, T& value)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(text.data(), text.size()) != tinyxml2::XML_SUCCESS) return false;
+    const tinyxml2::XMLElement* root = doc.FirstChildElement("root");
+    if (!root) return false;
+    read_xml(root, value);
+    return true;
+}
+
+template <typename T>
+bool from_xml(const std::string& text, std::vector<T>& values)
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(text.data(), text.size()) != tinyxml2::XML_SUCCESS) return false;
+    const tinyxml2::XMLElement* root = doc.FirstChildElement("root");
+    if (!root) return false;
+    values.clear();
+    for (const tinyxml2::XMLElement* e = root->FirstChildElement("item"); e; e = e->NextSiblingElement("item")) {
+        T value;
+        read_xml(e, value);
+        values.push_back(std::move(value));
+    }
+    return true;
+}
+
+} // namespace Handwritten
+
+} // namespace Bench
+
+#endif // BENCH_HANDWRITTEN_H
@@ -0,0 +1,132 @@
+#ifndef BENCH_LATENCY_H
+#define BENCH_LATENCY_H
+
+#include "bench_common.h"
+#include "histogram.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+// One row of the exported report
+struct LatencyResult
+{
+    std::string format;
+    std::string op;
+    uint64_t    count;
+    double      mean_ns;
+    uint64_t    min_ns;
+    uint64_t    p50_ns;
+    uint64_t    p90_ns;
+    uint64_t    p99_ns;
+    uint64_t    p999_ns;
+    uint64_t    max_ns;
+};
+
+struct LatencyReport
+{
+    std::string                stream;
+    std::vector<LatencyResult> results;
+};
+
+} // namespace Bench
+
+O_SERIALIZE_STRUCT(Bench::LatencyResult, format, op, count, mean_ns, min_ns, p50_ns, p90_ns, p99_ns, p999_ns, max_ns);
+O_SERIALIZE_STRUCT(Bench::LatencyReport, stream, results);
+
+namespace Bench {
+
+namespace Latency {
+
+// A stream of distinct orders of varying size, so allocator and DOM growth
+// behave as with live traffic rather than one message hot in cache
+inline std::vector<Order> make_stream()
+{
+    std::vector<Order> stream;
+    for (int i = 0; i < 500; ++i) stream.push_back(make_order(i, 1 + i * 7 % 40));
+    return stream;
+}
+
+// Times every single call of op(message) over repeated passes of the stream
+// until options.minSeconds have passed (and at least 10000 calls were made)
+template <typename Message, typename Op>
+Histogram time_calls(const std::vector<Message>& stream, const Options& options, Op&& op)
+{
+    Histogram               histogram;
+    const Clock::time_point begin = Clock::now();
+    while (histogram.count() < 10000 || seconds_since(begin) < options.minSeconds) {
+        for (const auto& message : stream) {
+            const Clock::time_point start = Clock::now();
+            op(message);
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            histogram.record(static_cast<uint64_t>(ns));
+        }
+    }
+    return histogram;
+}
+
+inline LatencyResult summarize(const char* format, const char* op, const Histogram& h)
+{
+    LatencyResult r;
+    r.format = format;
+    r.op = op;
+    r.count = h.count();
+    r.mean_ns = h.mean();
+    r.min_ns = h.min();
+    r.p50_ns = h.percentile(0.50);
+    r.p90_ns = h.percentile(0.90);
+    r.p99_ns = h.percentile(0.99);
+    r.p999_ns = h.percentile(0.999);
+    r.max_ns = h.max();
+    return r;
+}
+
+template <typename Format>
+void run_format(Format, const std::vector<Order>& orders, const Options& options, LatencyReport& report)
+{
+    if (std::string(Format::name()).find(options.filter) == std::string::npos) return;
+
+    std::vector<std::string> encoded;
+    for (const auto& order : orders) encoded.push_back(Format::encode(order));
+
+    report.results.push_back(summarize(Format::name(), "encode", time_calls(orders, options, [](const Order& order) {
+        std::string text = Format::encode(order);
+        do_not_optimize(text);
+    })));
+    report.results.push_back(summarize(Format::name(), "decode", time_calls(encoded, options, [](const std::string& text) {
+        Order out;
+        Format::decode(text, out);
+        do_not_optimize(out);
+    })));
+}
+
+// Prints the percentile table and, if jsonPath is not empty, writes the report there
+inline void run_all(const Options& options, const std::string& jsonPath)
+{
+    const std::vector<Order> orders = make_stream();
+    LatencyReport            report;
+    report.stream = "orders x" + std::to_string(orders.size()) + ", 1-40 items";
+
+    run_format(JsonFormat(), orders, options, report);
+    run_format(XmlFormat(), orders, options, report);
+    run_format(IniFormat(), orders, options, report);
+
+    std::printf("%-5s %-7s %10s %10s %10s %10s %10s %10s %10s\n", "fmt", "op", "calls", "mean", "p50", "p90", "p99",
+                "p99.9", "max");
+    for (const auto& r : report.results) {
+        std::printf("%-5s %-7s %10llu %10.0f %10llu %10llu %10llu %10llu %10llu\n", r.format.c_str(), r.op.c_str(),
+                    (unsigned long long)r.count, r.mean_ns, (unsigned long long)r.p50_ns, (unsigned long long)r.p90_ns,
+                    (unsigned long long)r.p99_ns, (unsigned long long)r.p999_ns, (unsigned long long)r.max_ns);
+    }
+
+    if (!jsonPath.empty() && !OSerialize::JSON::obj_to_file(report, jsonPath)) {
+        std::fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+    }
+}
+
+} // namespace Latency
+
+} // namespace Bench
+
+#endif // BENCH_LATENCY_H
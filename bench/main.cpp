@@ -0,0 +1,55 @@
+#include "latency_bench.h"
+#include "overhead_bench.h"
+#include "throughput_bench.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Usage: benchmarks [--perf] [--min-time SECONDS] [--filter FORMAT/SHAPE]
+//                   [--latency [--json FILE]]
+//                   [--overhead [--json FILE] [--baseline FILE] [--tolerance FRACTION]]
+int main(int argc, char** argv) {
+  Bench::Options options;
+  bool latency = false;
+  bool overhead = false;
+  std::string jsonPath;
+  std::string baselinePath;
+  double tolerance = 0.10;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--perf") == 0) {
+      options.perf = true;
+    } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      options.minSeconds = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--latency") == 0) {
+      latency = true;
+    } else if (std::strcmp(argv[i], "--overhead") == 0) {
+      overhead = true;
+    } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baselinePath = argv[++i];
+    } else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      jsonPath = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--perf] [--min-time SECONDS] [--filter FORMAT/SHAPE]"
+                << " [--latency [--json FILE]]"
+                << " [--overhead [--json FILE] [--baseline FILE] [--tolerance FRACTION]]" << std::endl;
+      return 1;
+    }
+  }
+
+  if (overhead) {
+    std::cout << "=== Overhead vs hand-written code ===" << std::endl;
+    return Bench::Overhead::run_all(options, jsonPath, baselinePath, tolerance) ? 0 : 2;
+  }
+  if (latency) {
+    std::cout << "=== Latency (ns per call) ===" << std::endl;
+    Bench::Latency::run_all(options, jsonPath);
+  } else {
+    std::cout << "=== Throughput ===" << std::endl;
+    Bench::Throughput::run_all(options);
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+#ifndef BENCH_OVERHEAD_H
+#define BENCH_OVERHEAD_H
+
+#include "bench_common.h"
+#include "handwritten.h"
+#include "o_serialize/diff.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+// One library-vs-hand-written comparison; ratio = library_ns / handwritten_ns
+struct OverheadResult
+{
+    std::string name;
+    double      library_ns;
+    double      handwritten_ns;
+    double      ratio;
+};
+
+struct OverheadReport
+{
+    std::vector<OverheadResult> results;
+};
+
+} // namespace Bench
+
+O_SERIALIZE_STRUCT(Bench::OverheadResult, name, library_ns, handwritten_ns, ratio);
+O_SERIALIZE_STRUCT(Bench::OverheadReport, results);
+
+namespace Bench {
+
+// Measures what the reflection layer costs on top of the parser it wraps: every
+// case runs the same payload through OSerialize and through the hand-written
+// rapidjson / tinyxml2 code in handwritten.h, and reports the time ratio.
+// A saved report can be passed back as a baseline to catch regressions.
+namespace Overhead {
+
+struct Handwritten
+{
+    template <typename T>
+    static std::string encode_json(const T& value) { return Bench::Handwritten::to_json(value); }
+
+    template <typename T>
+    static bool decode_json(const std::string& text, T& value) { return Bench::Handwritten::from_json(text, value); }
+
+    template <typename T>
+    static std::string encode_xml(const T& value) { return Bench::Handwritten::to_xml(value); }
+
+    template <typename T>
+    static bool decode_xml(const std::string& text, T& value) { return Bench::Handwritten::from_xml(text, value); }
+};
+
+// Nanoseconds per call of op
+template <typename Op>
+double time_per_call(const Options& options, Op&& op)
+{
+    const long              iterations = calibrate(options, op);
+    const Clock::time_point start = Clock::now();
+    for (long i = 0; i < iterations; ++i) op();
+    return seconds_since(start) * 1e9 / iterations;
+}
+
+template <typename LibOp, typename HandOp>
+void compare(const std::string& name, const Options& options, OverheadReport& report, LibOp&& library,
+             HandOp&& handwritten)
+{
+    if (name.find(options.filter) == std::string::npos) return;
+    OverheadResult r;
+    r.name = name;
+    r.library_ns = time_per_call(options, library);
+    r.handwritten_ns = time_per_call(options, handwritten);
+    r.ratio = r.library_ns / r.handwritten_ns;
+    report.results.push_back(r);
+}
+
+// Checks both implementations agree on the payload before timing them, so a
+// fast hand-written path cannot be fast by doing less. Results are compared with
+// each other rather than with value: rapidjson's default double parsing is not
+// exact, for the library and the hand-written code alike.
+template <typename Format, typename T, typename Encode, typename Decode>
+bool agrees(const T& value, Encode&& encode, Decode&& decode)
+{
+    const std::string text = Format::encode(value);
+    T                 library{};
+    T                 handwritten{};
+    T                 reread{};
+    return Format::decode(text, library) && decode(text, handwritten) && OSerialize::Diff::equal(library, handwritten)
+        && Format::decode(encode(value), reread) && OSerialize::Diff::equal(library, reread);
+}
+
+template <typename T>
+void run_shape(const char* shape, const T& value, const Options& options, OverheadReport& report)
+{
+    const std::string json = JsonFormat::encode(value);
+    const std::string xml = XmlFormat::encode(value);
+
+    if (!agrees<JsonFormat>(value, Handwritten::encode_json<T>, Handwritten::decode_json<T>)
+        || !agrees<XmlFormat>(value, Handwritten::encode_xml<T>, Handwritten::decode_xml<T>)) {
+        std::fprintf(stderr, "%s: hand-written codec disagrees with the library, skipped\n", shape);
+        return;
+    }
+
+    const std::string prefix = std::string("/") + shape + "/";
+    compare("json" + prefix + "encode", options, report,
+            [&] { do_not_optimize(JsonFormat::encode(value)); },
+            [&] { do_not_optimize(Handwritten::encode_json(value)); });
+    compare("json" + prefix + "decode", options, report,
+            [&] { T out; JsonFormat::decode(json, out); do_not_optimize(out); },
+            [&] { T out; Handwritten::decode_json(json, out); do_not_optimize(out); });
+    compare("xml" + prefix + "encode", options, report,
+            [&] { do_not_optimize(XmlFormat::encode(value)); },
+            [&] { do_not_optimize(Handwritten::encode_xml(value)); });
+    compare("xml" + prefix + "decode", options, report,
+            [&] { T out; XmlFormat::decode(xml, out); do_not_optimize(out); },
+            [&] { T out; Handwritten::decode_xml(xml, out); do_not_optimize(out); });
+}
+
+// Number of cases whose ratio grew by more than tolerance (0.10 = 10%) over the baseline
+inline int regressions(const OverheadReport& report, const OverheadReport& baseline, double tolerance)
+{
+    int count = 0;
+    for (const auto& r : report.results) {
+        for (const auto& b : baseline.results) {
+            if (b.name != r.name || r.ratio <= b.ratio * (1 + tolerance)) continue;
+            std::printf("REGRESSION %-22s ratio %.2f, baseline %.2f\n", r.name.c_str(), r.ratio, b.ratio);
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Prints the ratio table, writes it to jsonPath and compares it with baselinePath
+// (both optional). Returns false if any case regressed against the baseline.
+inline bool run_all(const Options& options, const std::string& jsonPath, const std::string& baselinePath,
+                    double tolerance)
+{
+    OverheadReport report;
+    run_shape("order", make_order(1, 20), options, report);
+    run_shape("orders", make_orders(200), options, report);
+    run_shape("generated", make_generated_orders(200), options, report);
+
+    std::printf("%-22s %14s %14s %8s\n", "case", "library ns", "handwritten ns", "ratio");
+    for (const auto& r : report.results) {
+        std::printf("%-22s %14.0f %14.0f %8.2f\n", r.name.c_str(), r.library_ns, r.handwritten_ns, r.ratio);
+    }
+
+    if (!jsonPath.empty() && !OSerialize::JSON::obj_to_file(report, jsonPath)) {
+        std::fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+    }
+    if (baselinePath.empty()) return true;
+
+    OverheadReport baseline;
+    if (!OSerialize::JSON::try_file_to_obj(baselinePath, baseline)) {
+        std::fprintf(stderr, "Cannot read baseline %s\n", baselinePath.c_str());
+        return false;
+    }
+    return regressions(report, baseline, tolerance) == 0;
+}
+
+} // namespace Overhead
+
+} // namespace Bench
+
+#endif // BENCH_OVERHEAD_H
@@ -0,0 +1,96 @@
+#ifndef BENCH_PAYLOADS_H
+#define BENCH_PAYLOADS_H
+
+#include "o_serialize/generate.h"
+#include "o_serialize/o_serialize.h"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+struct Flat
+{
+    int         id;
+    double      price;
+    bool        active;
+    std::string name;
+};
+
+struct Item
+{
+    int         sku;
+    int         qty;
+    double      price;
+    std::string title;
+};
+
+struct Order
+{
+    int                                id;
+    std::string                        customer;
+    Flat                               meta;
+    std::vector<Item>                  items;
+    std::map<std::string, std::string> tags;
+};
+
+inline Flat make_flat(int i)
+{
+    return Flat{i, 19.99 + i, i % 2 == 0, "product-" + std::to_string(i)};
+}
+
+inline Order make_order(int i, int itemCount)
+{
+    Order order;
+    order.id = i;
+    order.customer = "customer-" + std::to_string(i);
+    order.meta = make_flat(i);
+    for (int n = 0; n < itemCount; ++n) {
+        order.items.push_back(Item{1000 + n, n % 5 + 1, 0.5 * n + 1.25, "item title " + std::to_string(n)});
+    }
+    order.tags["channel"] = "web";
+    order.tags["region"] = "eu-west";
+    return order;
+}
+
+inline std::vector<int> make_ints(int count)
+{
+    std::vector<int> ints;
+    for (int i = 0; i < count; ++i) ints.push_back(i * 7919 % 100003);
+    return ints;
+}
+
+inline std::vector<Order> make_orders(int count)
+{
+    std::vector<Order> orders;
+    for (int i = 0; i < count; ++i) orders.push_back(make_order(i, 8));
+    return orders;
+}
+
+} // namespace Bench
+
+O_SERIALIZE_STRUCT(Bench::Flat, id, price, active, name);
+O_SERIALIZE_STRUCT(Bench::Item, sku, qty, price, title);
+O_SERIALIZE_STRUCT(Bench::Order, id, customer, meta, items, tags);
+
+namespace Bench {
+
+// Random orders from a fixed seed: irregular sizes and values instead of the
+// uniform make_orders, the same on every run
+inline std::vector<Order> make_generated_orders(int count)
+{
+    OSerialize::GenerateShape shape;
+    shape.minItems = 1;
+    shape.maxItems = 16;
+    shape.maxString = 24;
+    std::mt19937_64 rng(20240501);
+
+    std::vector<Order> orders(count);
+    for (Order& order : orders) OSerialize::Generate(rng, order, shape);
+    return orders;
+}
+
+} // namespace Bench
+
+#endif // BENCH_PAYLOADS_H
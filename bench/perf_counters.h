@@ -0,0 +1,125 @@
+#ifndef BENCH_PERF_COUNTERS_H
+#define BENCH_PERF_COUNTERS_H
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Bench {
+
+// Hardware/software counters of the calling thread, read with perf_event_open.
+//
+// Each event is opened on its own, so a PMU that lacks one event (or a VM that
+// exposes no PMU at all) only loses that column. Counting is user space only,
+// which works under the default perf_event_paranoid setting. Counts are scaled
+// when the kernel had to multiplex events.
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, BranchMisses, L1DMisses, LLCMisses, PageFaults, EventCount };
+
+    struct Sample {
+        bool     valid[EventCount] = {};
+        uint64_t value[EventCount] = {};
+    };
+
+    static const char* name(int event)
+    {
+        static const char* const names[EventCount] = {"cycles", "instr", "br-miss", "L1d-miss", "LLC-miss", "faults"};
+        return names[event];
+    }
+
+    PerfCounters()
+    {
+#ifdef __linux__
+        const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        _fd[Cycles] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        _fd[Instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        _fd[BranchMisses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        _fd[L1DMisses] = open(PERF_TYPE_HW_CACHE, l1dReadMiss);
+        _fd[LLCMisses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        _fd[PageFaults] = open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int fd : _fd) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // True if at least one event could be opened
+    bool available() const
+    {
+        for (int fd : _fd) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        for (int fd : _fd) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    Sample stop()
+    {
+        Sample sample;
+#ifdef __linux__
+        for (int fd : _fd) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (int i = 0; i < EventCount; ++i) {
+            uint64_t data[3]; // value, time enabled, time running
+            if (_fd[i] < 0 || ::read(_fd[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+            if (data[2] == 0) continue; // never scheduled
+            sample.valid[i] = true;
+            sample.value[i] = data[2] < data[1]
+                                  ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2])
+                                  : data[0];
+        }
+#endif
+        return sample;
+    }
+
+private:
+#ifdef __linux__
+    static int open(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    int _fd[EventCount] = {-1, -1, -1, -1, -1, -1};
+};
+
+} // namespace Bench
+
+#endif // BENCH_PERF_COUNTERS_H
@@ -0,0 +1,79 @@
+#ifndef BENCH_THROUGHPUT_H
+#define BENCH_THROUGHPUT_H
+
+#include "bench_common.h"
+#include "perf_counters.h"
+#include <cstdio>
+#include <string>
+
+namespace Bench {
+
+namespace Throughput {
+
+// Runs op in a loop for about options.minSeconds and prints one result row:
+// ns and MB/s per operation, plus hardware counters per operation with --perf
+template <typename Op>
+void measure(const char* format, const char* shape, const char* opName, size_t bytes, const Options& options,
+             PerfCounters* counters, Op&& op)
+{
+    const long iterations = calibrate(options, op);
+
+    if (counters) counters->start();
+    const Clock::time_point start = Clock::now();
+    for (long i = 0; i < iterations; ++i) op();
+    const double elapsed = seconds_since(start);
+    PerfCounters::Sample sample;
+    if (counters) sample = counters->stop();
+
+    const double nsPerOp = elapsed * 1e9 / iterations;
+    std::printf("%-5s %-9s %-7s %10ld %12.1f %9.1f", format, shape, opName, iterations, nsPerOp,
+                bytes / nsPerOp * 1e9 / (1024 * 1024));
+    if (counters) {
+        for (int e = 0; e < PerfCounters::EventCount; ++e) {
+            if (sample.valid[e]) std::printf(" %10.1f", static_cast<double>(sample.value[e]) / iterations);
+            else std::printf(" %10s", "-");
+        }
+    }
+    std::printf("\n");
+}
+
+template <typename Format, typename T>
+void run_case(Format, const char* shape, const T& value, const Options& options, PerfCounters* counters)
+{
+    const std::string encoded = Format::encode(value);
+    measure(Format::name(), shape, "encode", encoded.size(), options, counters, [&] {
+        std::string text = Format::encode(value);
+        do_not_optimize(text);
+    });
+    measure(Format::name(), shape, "decode", encoded.size(), options, counters, [&] {
+        T out{};
+        Format::decode(encoded, out);
+        do_not_optimize(out);
+    });
+}
+
+inline void run_all(const Options& options)
+{
+    PerfCounters  perf;
+    PerfCounters* counters = nullptr;
+    if (options.perf) {
+        if (perf.available()) counters = &perf;
+        else std::printf("perf_event_open unavailable, reporting wall-clock only\n");
+    }
+
+    std::printf("%-5s %-9s %-7s %10s %12s %9s", "fmt", "shape", "op", "iters", "ns/op", "MB/s");
+    if (counters) {
+        for (int e = 0; e < PerfCounters::EventCount; ++e) std::printf(" %10s", PerfCounters::name(e));
+    }
+    std::printf("\n");
+
+    for_each_case(options, [&](auto format, const char* shape, const auto& value) {
+        run_case(format, shape, value, options, counters);
+    });
+}
+
+} // namespace Throughput
+
+} // namespace Bench
+
+#endif // BENCH_THROUGHPUT_H
@@ -33,6 +33,11 @@
 #include <QWeakPointer>
 #include <QPointer>
 #include <QScopedPointer>
+#include <QByteArray>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include <QColor>
 #endif
 
 namespace OSerialize {
@@ -76,6 +81,20 @@ namespace Traits {
     template <typename T> struct is_tuple : std::false_type {};
     template <typename... Args> struct is_tuple<std::tuple<Args...>> : std::true_type {};
 
+    // 可以用单个文本值表示的类型（算术、枚举、字符串、日期等），
+    // 可写为 XML 属性或 INI 键值
+    template <typename T> struct is_text_scalar
+        : std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value> {};
+    template <> struct is_text_scalar<std::string> : std::true_type {};
+#ifdef O_SERIALIZE_USE_QT
+    template <> struct is_text_scalar<QString> : std::true_type {};
+    template <> struct is_text_scalar<QByteArray> : std::true_type {};
+    template <> struct is_text_scalar<QDate> : std::true_type {};
+    template <> struct is_text_scalar<QTime> : std::true_type {};
+    template <> struct is_text_scalar<QDateTime> : std::true_type {};
+    template <> struct is_text_scalar<QColor> : std::true_type {};
+#endif
+
     // --- Qt Traits ---
 
 #ifdef O_SERIALIZE_USE_QT
@@ -0,0 +1,128 @@
+#ifndef O_SERIALIZE_DIFF_H
+#define O_SERIALIZE_DIFF_H
+
+#include "o_serialize/base.h"
+#include "o_serialize/o_serialize.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OSerialize {
+
+// Member-by-member comparison of reflected objects.
+//
+// Reflected members are walked recursively and reported by their dotted path
+// ("db.pool.max"); any other member (scalars, strings, containers, maps) is a leaf
+// that is reported as a whole when it differs.
+class Diff {
+public:
+    // Deep equality: reflected members, smart pointer targets and container
+    // elements are compared recursively, everything else with ==.
+    template <typename T>
+    static bool equal(const T& a, const T& b) {
+        if constexpr (Meta::has_reflection<T>::value) {
+            bool same = true;
+            Meta::visit_fields<T>([&](const char*, auto field) {
+                same = same && equal(a.*field, b.*field);
+            });
+            return same;
+        } else if constexpr (!is_deep<T>()) {
+            return a == b;
+        } else if constexpr (Traits::is_smart_ptr<T>::value || Traits::is_qt_smart_ptr<T>::value) {
+            return (!a || !b) ? (!a && !b) : equal(*a, *b);
+        } else if constexpr (Traits::is_stl_map<T>::value) {
+            if (a.size() != b.size()) return false;
+            for (const auto& pair : a) {
+                auto other = b.find(pair.first);
+                if (other == b.end() || !equal(pair.second, other->second)) return false;
+            }
+            return true;
+        } else if constexpr (Traits::is_qt_map<T>::value) {
+            if (a.size() != b.size()) return false;
+            for (auto it = a.begin(); it != a.end(); ++it) {
+                auto other = b.find(it.key());
+                if (other == b.end() || !equal(it.value(), other.value())) return false;
+            }
+            return true;
+        } else {
+            if (a.size() != b.size()) return false;
+            auto other = b.begin();
+            for (const auto& item : a) {
+                if (!equal(item, *other)) return false;
+                ++other;
+            }
+            return true;
+        }
+    }
+
+    // Calls callback(path) for every leaf member that differs between before and after
+    template <typename T, typename Callback>
+    static void compare(const T& before, const T& after, Callback&& callback) {
+        std::string path;
+        compare_at(path, before, after, callback);
+    }
+
+    template <typename T>
+    static std::vector<std::string> changed_fields(const T& before, const T& after) {
+        std::vector<std::string> changed;
+        compare(before, after, [&](const std::string& path) { changed.push_back(path); });
+        return changed;
+    }
+
+    // Moves only the leaf members of fresh that differ into live and calls
+    // callback(path) for each; unchanged members of live are left untouched.
+    template <typename T, typename Callback>
+    static void apply(T& live, T&& fresh, Callback&& callback) {
+        std::string path;
+        apply_at(path, live, fresh, callback);
+    }
+
+private:
+    // Types whose == may not exist because it would need == on a reflected type
+    template <typename T>
+    static constexpr bool is_deep() {
+        if constexpr (Meta::has_reflection<T>::value) return true;
+        else if constexpr (Traits::is_smart_ptr<T>::value || Traits::is_qt_smart_ptr<T>::value) return true;
+        else if constexpr (Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value) return is_deep<typename T::mapped_type>();
+        else if constexpr (Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value) return is_deep<typename T::value_type>();
+        else return false;
+    }
+
+    // Appends ".name" to path for the duration of f
+    template <typename F>
+    static void with_member(std::string& path, const char* name, F&& f) {
+        const size_t size = path.size();
+        if (!path.empty()) path += '.';
+        path += name;
+        f();
+        path.resize(size);
+    }
+
+    template <typename T, typename Callback>
+    static void compare_at(std::string& path, const T& before, const T& after, Callback& callback) {
+        if constexpr (Meta::has_reflection<T>::value) {
+            Meta::visit_fields<T>([&](const char* name, auto field) {
+                with_member(path, name, [&] { compare_at(path, before.*field, after.*field, callback); });
+            });
+        } else if (!equal(before, after)) {
+            callback(static_cast<const std::string&>(path));
+        }
+    }
+
+    template <typename T, typename Callback>
+    static void apply_at(std::string& path, T& live, T& fresh, Callback& callback) {
+        if constexpr (Meta::has_reflection<T>::value) {
+            Meta::visit_fields<T>([&](const char* name, auto field) {
+                with_member(path, name, [&] { apply_at(path, live.*field, fresh.*field, callback); });
+            });
+        } else if (!equal(live, fresh)) {
+            if constexpr (std::is_move_assignable<T>::value) live = std::move(fresh);
+            else live.swap(fresh); // QScopedPointer
+            callback(static_cast<const std::string&>(path));
+        }
+    }
+};
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_DIFF_H
@@ -0,0 +1,200 @@
+#ifndef O_SERIALIZE_FILE_IO_H
+#define O_SERIALIZE_FILE_IO_H
+
+#include "o_serialize/options.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace OSerialize {
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Whole-file read access for the parsers. Large files are memory-mapped and
+// parsed straight from the page cache; small ones (below kMapThreshold), where
+// setting up the mapping costs more than a copy, are read with one read().
+// A mapped file must not be truncated while it is open (SIGBUS); write
+// replacements to a new file and rename() them over the old one.
+class MappedFile {
+public:
+    static constexpr size_t kMapThreshold = 64 * 1024;
+
+    explicit MappedFile(const std::string& filepath) {
+        _fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (_fd < 0) return;
+        struct stat st;
+        if (::fstat(_fd, &st) != 0) {
+            close();
+            return;
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        if (size < kMapThreshold) {
+            if (!read_all(size)) close();
+            return;
+        }
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (p == MAP_FAILED) {
+            if (!read_all(size)) close();
+            return;
+        }
+        ::madvise(p, size, MADV_SEQUENTIAL);
+        _map = p;
+        _data = static_cast<const char*>(p);
+        _size = size;
+    }
+
+    ~MappedFile() {
+        if (_map) ::munmap(_map, _size);
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return _fd >= 0; }
+    bool is_mapped() const { return _map != nullptr; }
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    // Reads until EOF, so files that changed size since fstat() are still read whole
+    bool read_all(size_t sizeHint) {
+        _copy.resize(sizeHint + 1);
+        size_t used = 0;
+        for (;;) {
+            if (used == _copy.size()) _copy.resize(_copy.size() * 2);
+            ssize_t n = ::read(_fd, &_copy[used], _copy.size() - used);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return false;
+            if (n == 0) break;
+            used += static_cast<size_t>(n);
+        }
+        _copy.resize(used);
+        _data = _copy.data();
+        _size = used;
+        return true;
+    }
+
+    void close() {
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    int _fd = -1;
+    void* _map = nullptr;
+    const char* _data = "";
+    size_t _size = 0;
+    std::string _copy;
+};
+
+// rapidjson output stream that writes to a file descriptor through a large
+// page-aligned buffer. Full buffers are written at aligned offsets, so the file
+// can be opened with O_DIRECT (WriteOptions::directIO); the final partial block
+// is written after O_DIRECT is switched off again.
+class FdWriteStream {
+public:
+    typedef char Ch;
+
+    static constexpr size_t kBufferSize = 256 * 1024;
+    static constexpr size_t kAlignment = 4096;
+
+    explicit FdWriteStream(int fd) : _fd(fd) {
+        void* p = nullptr;
+        if (::posix_memalign(&p, kAlignment, kBufferSize) != 0) throw std::bad_alloc();
+        _buf = static_cast<char*>(p);
+    }
+
+    ~FdWriteStream() { std::free(_buf); }
+
+    FdWriteStream(const FdWriteStream&) = delete;
+    FdWriteStream& operator=(const FdWriteStream&) = delete;
+
+    // Opens filepath for writing the way options ask for; -1 on failure
+    static int open(const std::string& filepath, const WriteOptions& options) {
+        const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        int fd = -1;
+#ifdef O_DIRECT
+        // Not every filesystem supports O_DIRECT (tmpfs does not); fall back to buffered I/O
+        if (options.directIO) fd = ::open(filepath.c_str(), flags | O_DIRECT, 0644);
+#endif
+        if (fd < 0) fd = ::open(filepath.c_str(), flags, 0644);
+#ifdef __linux__
+        // Reserves the extents up front without changing the file size; a failure
+        // (e.g. unsupported filesystem) only loses the optimization
+        if (fd >= 0 && options.preallocate > 0) {
+            (void)::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(options.preallocate));
+        }
+#endif
+        return fd;
+    }
+
+    void Put(Ch c) {
+        if (_size == kBufferSize) flush_full();
+        _buf[_size++] = c;
+    }
+
+    // Called by rapidjson writers at the end of the document; the tail is written
+    // by finish()
+    void Flush() {}
+
+    // Writes what is left in the buffer; false if any write failed
+    bool finish() {
+        if (!_ok || _size == 0) return _ok;
+#ifdef O_DIRECT
+        const int flags = ::fcntl(_fd, F_GETFL);
+        if (flags >= 0 && (flags & O_DIRECT)) ::fcntl(_fd, F_SETFL, flags & ~O_DIRECT);
+#endif
+        write_all(_buf, _size);
+        _size = 0;
+        return _ok;
+    }
+
+    size_t written() const { return _written; }
+
+    // Not an input stream
+    Ch Peek() const { return 0; }
+    Ch Take() { return 0; }
+    size_t Tell() const { return _written + _size; }
+    Ch* PutBegin() { return nullptr; }
+    size_t PutEnd(Ch*) { return 0; }
+
+private:
+    void flush_full() {
+        write_all(_buf, _size);
+        _size = 0;
+    }
+
+    void write_all(const char* data, size_t size) {
+        while (_ok && size > 0) {
+            ssize_t n = ::write(_fd, data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) { _ok = false; break; }
+            data += n;
+            size -= static_cast<size_t>(n);
+            _written += static_cast<size_t>(n);
+        }
+    }
+
+    int _fd;
+    bool _ok = true;
+    char* _buf = nullptr;
+    size_t _size = 0;
+    size_t _written = 0;
+};
+
+#endif
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_FILE_IO_H
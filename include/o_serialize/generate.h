@@ -0,0 +1,177 @@
+#ifndef O_SERIALIZE_GENERATE_H
+#define O_SERIALIZE_GENERATE_H
+
+#include "o_serialize/base.h"
+#include "o_serialize/o_serialize.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace OSerialize {
+
+// Size limits for Generate. Depth counts nested reflected objects, containers,
+// maps and pointers; past maxDepth containers stay empty and pointers null, so
+// recursive types terminate.
+struct GenerateShape {
+    size_t      minItems = 0;       // elements per container / map
+    size_t      maxItems = 8;
+    size_t      minString = 0;      // characters per string
+    size_t      maxString = 16;
+    int         maxDepth = 4;
+    double      nullChance = 0.1;   // probability of an empty smart pointer
+    // Characters strings are drawn from. The default is safe as INI values and
+    // XML text; map keys additionally start with a letter so they are valid
+    // XML element names.
+    std::string alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+};
+
+// Fills values with random data, walking reflected types with visit_members.
+//
+// Arithmetic members cover their whole range (floating point: +-1e6), strings
+// and containers follow the shape. Enums are left value-initialized, since the
+// valid enumerators are not known. Unsupported members keep their default.
+template <typename Rng>
+class Generator {
+public:
+    Generator(Rng& rng, const GenerateShape& shape) : _rng(rng), _shape(shape) {}
+
+    template <typename T>
+    void fill(T& value, int depth = 0) {
+        if constexpr (Meta::has_reflection<T>::value) {
+            Meta::visit_members(value, [&](const char*, auto& member) { fill(member, depth + 1); });
+        } else if constexpr (std::is_same<T, bool>::value) {
+            value = std::bernoulli_distribution(0.5)(_rng);
+        } else if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value
+                             || std::is_same<T, unsigned char>::value) {
+            value = static_cast<T>(pick_char());
+        } else if constexpr (std::is_integral<T>::value) {
+            // uniform_int_distribution is not defined for every integral type
+            using Wide = typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type;
+            value = static_cast<T>(std::uniform_int_distribution<Wide>(std::numeric_limits<T>::lowest(),
+                                                                       std::numeric_limits<T>::max())(_rng));
+        } else if constexpr (std::is_floating_point<T>::value) {
+            value = static_cast<T>(std::uniform_real_distribution<double>(-1e6, 1e6)(_rng));
+        } else if constexpr (std::is_enum<T>::value) {
+            value = T{};
+        } else if constexpr (std::is_same<T, std::string>::value) {
+            value = make_string();
+        } else if constexpr (Traits::is_pair<T>::value) {
+            fill(value.first, depth + 1);
+            fill(value.second, depth + 1);
+        } else if constexpr (Traits::is_tuple<T>::value) {
+            std::apply([&](auto&... items) { (fill(items, depth + 1), ...); }, value);
+        } else if constexpr (Traits::is_variant<T>::value) {
+            fill_variant(value, std::uniform_int_distribution<size_t>(0, std::variant_size<T>::value - 1)(_rng),
+                         depth, std::make_index_sequence<std::variant_size<T>::value>());
+        } else if constexpr (Traits::is_smart_ptr<T>::value) {
+            value.reset();
+            if (depth >= _shape.maxDepth || std::bernoulli_distribution(_shape.nullChance)(_rng)) return;
+            value.reset(new typename T::element_type());
+            fill(*value, depth + 1);
+        } else if constexpr (Traits::is_stl_map<T>::value) {
+            value.clear();
+            if (depth >= _shape.maxDepth) return;
+            for (size_t n = item_count(); n > 0; --n) {
+                typename T::key_type    key;
+                typename T::mapped_type mapped;
+                fill_key(key, depth + 1);
+                fill(mapped, depth + 1);
+                value.emplace(std::move(key), std::move(mapped));
+            }
+        } else if constexpr (Traits::is_stl_container<T>::value) {
+            value.clear();
+            if (depth >= _shape.maxDepth) return;
+            for (size_t n = item_count(); n > 0; --n) {
+                typename T::value_type item;
+                fill(item, depth + 1);
+                value.insert(value.end(), std::move(item));
+            }
+        }
+#ifdef O_SERIALIZE_USE_QT
+        else if constexpr (std::is_same<T, QString>::value) {
+            value = QString::fromStdString(make_string());
+        } else if constexpr (std::is_same<T, QByteArray>::value) {
+            value = QByteArray::fromStdString(make_string());
+        } else if constexpr (Traits::is_qpair<T>::value) {
+            fill(value.first, depth + 1);
+            fill(value.second, depth + 1);
+        } else if constexpr (Traits::is_qt_map<T>::value) {
+            value.clear();
+            if (depth >= _shape.maxDepth) return;
+            for (size_t n = item_count(); n > 0; --n) {
+                typename T::key_type    key;
+                typename T::mapped_type mapped;
+                fill_key(key, depth + 1);
+                fill(mapped, depth + 1);
+                value.insert(key, mapped);
+            }
+        } else if constexpr (Traits::is_qt_container<T>::value) {
+            value.clear();
+            if (depth >= _shape.maxDepth) return;
+            for (size_t n = item_count(); n > 0; --n) {
+                typename T::value_type item;
+                fill(item, depth + 1);
+                value << item;
+            }
+        }
+#endif
+    }
+
+private:
+    char pick_char() {
+        return _shape.alphabet[std::uniform_int_distribution<size_t>(0, _shape.alphabet.size() - 1)(_rng)];
+    }
+
+    std::string make_string() {
+        std::string s(std::uniform_int_distribution<size_t>(_shape.minString, _shape.maxString)(_rng), '\0');
+        for (char& c : s) c = pick_char();
+        return s;
+    }
+
+    size_t item_count() { return std::uniform_int_distribution<size_t>(_shape.minItems, _shape.maxItems)(_rng); }
+
+    // String keys start with a letter so every backend can use them as names
+    template <typename K>
+    void fill_key(K& key, int depth) {
+        fill(key, depth);
+        if constexpr (std::is_same<K, std::string>::value) {
+            key.insert(key.begin(), static_cast<char>('a' + std::uniform_int_distribution<int>(0, 25)(_rng)));
+        }
+#ifdef O_SERIALIZE_USE_QT
+        else if constexpr (std::is_same<K, QString>::value) {
+            key.prepend(QChar('a' + std::uniform_int_distribution<int>(0, 25)(_rng)));
+        }
+#endif
+    }
+
+    template <typename T, size_t... I>
+    void fill_variant(T& value, size_t index, int depth, std::index_sequence<I...>) {
+        ((index == I ? (fill(value.template emplace<I>(), depth + 1), true) : false) || ...);
+    }
+
+    Rng&                 _rng;
+    const GenerateShape& _shape;
+};
+
+// A T filled with random data, e.g.
+//   std::mt19937_64 rng(42);
+//   auto orders = OSerialize::Generate<std::vector<Order>>(rng, shape);
+template <typename T, typename Rng>
+T Generate(Rng& rng, const GenerateShape& shape = GenerateShape()) {
+    T value{};
+    Generator<Rng>(rng, shape).fill(value);
+    return value;
+}
+
+// Refills an existing object, for types that cannot be returned by value
+template <typename T, typename Rng>
+void Generate(Rng& rng, T& value, const GenerateShape& shape = GenerateShape()) {
+    Generator<Rng>(rng, shape).fill(value);
+}
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_GENERATE_H
@@ -3,10 +3,22 @@
 
 #include "o_serialize/base.h"
 #include "o_serialize/o_serialize.h"
-#include "inipp/inipp.h"
+#include "o_serialize/file_io.h"
+#include "o_serialize/number.h"
+#include "o_serialize/options.h"
+#include "o_serialize/ini_reader.h"
+#include "o_serialize/stats.h"
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <fstream>
+#include <iterator>
 #include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 #ifdef O_SERIALIZE_USE_QT
 #include <QDateTime>
@@ -25,91 +37,246 @@ namespace OSerialize {
 
 class INI {
 public:
+    // options: Compact omits the blank line after each section; keyOrder and
+    // maxDecimalPlaces apply as for JSON and XML. INI has no indentation.
     template <typename T>
-    static std::string stringify(const T& obj, const std::string& sectionName = "default") {
-        inipp::Ini<char> ini;
-        to_ini(obj, ini.sections[sectionName]);
-        
-        std::stringstream ss;
-        ini.generate(ss);
-        return ss.str();
+    static std::string stringify(const T& obj, const std::string& sectionName = "default", const WriteOptions& options = WriteOptions::pretty()) {
+        O_SERIALIZE_STATS_SCOPE();
+        std::string out;
+        std::string path = sectionName;
+        write_section(out, path, obj, options);
+        O_SERIALIZE_STATS_OUTPUT(out.size());
+        return out;
     }
 
     template <typename T>
     static T parse(const std::string& iniStr, const std::string& sectionName = "default") {
-        inipp::Ini<char> ini;
-        std::istringstream is(iniStr);
-        ini.parse(is);
-        
         T obj;
-        if (ini.sections.find(sectionName) == ini.sections.end()) {
-             return obj;
+        try_parse(iniStr, obj, sectionName);
+        return obj;
+    }
+
+    // Non-throwing variant of parse(): returns false when the section is missing
+    // or a value cannot be converted to its member type.
+    // iniStr is tokenized in place; keys and values are never copied.
+    template <typename T>
+    static bool try_parse(std::string_view iniStr, T& obj, const std::string& sectionName = "default") {
+        O_SERIALIZE_STATS_SCOPE();
+        INIReader reader(iniStr);
+        const Section* section = reader.section(sectionName);
+        if (!section) {
+             return false;
         }
 
-        from_ini(ini.sections[sectionName], obj);
-        return obj;
+        return from_ini(reader, *section, obj);
+    }
+
+    // Runs try_parse() on the file contents. INIReader is zero-copy, so on POSIX
+    // systems the tokens point straight into the mapped file.
+    template <typename T>
+    static bool try_file_to_obj(const std::string& filepath, T& obj, const std::string& sectionName = "default") {
+        O_SERIALIZE_STATS_SCOPE();
+#if defined(__unix__) || defined(__APPLE__)
+        MappedFile file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open file: " << filepath << std::endl;
+            return false;
+        }
+        return try_parse(std::string_view(file.data(), file.size()), obj, sectionName);
+#else
+        std::ifstream ifs(filepath, std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "Cannot open file: " << filepath << std::endl;
+            return false;
+        }
+        std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        return try_parse(text, obj, sectionName);
+#endif
     }
 
 private:
+    using Section = INIReader::Section;
+
     // --- Helper for container insert ---
     template <typename C, typename V>
-    static auto add_item(C& c, const V& v) -> decltype(c.push_back(v)) { c.push_back(v); }
+    static auto add_item(C& c, const V& v) -> decltype(c.push_back(v)) { return c.push_back(v); }
 
     template <typename C, typename V>
-    static auto add_item(C& c, const V& v) -> decltype(c.insert(v)) { c.insert(v); }
+    static auto add_item(C& c, const V& v) -> decltype(c.insert(v)) { return c.insert(v); }
+
+    template <typename C>
+    static auto reserve_items(C& c, size_t n, int) -> decltype(c.reserve(n), void()) { c.reserve(n); }
+
+    template <typename C>
+    static void reserve_items(C&, size_t, long) {}
+
+    // Container items are stored as item0, item1, ...
+    static std::string_view item_key(char* buf, size_t index) {
+        std::memcpy(buf, "item", 4);
+        char* last = Number::format(buf + 4, buf + 4 + Number::kBufferSize, index);
+        return std::string_view(buf, static_cast<size_t>(last - buf));
+    }
+
+    // A map key becomes one component of a dotted section path, so '.' (and '%',
+    // and line breaks, which would end the header) are written as %XX and
+    // decoded again when the map is read
+    static std::string path_component(std::string_view key) {
+        std::string out;
+        out.reserve(key.size());
+        for (char c : key) {
+            if (c == '.' || c == '%' || c == '\n' || c == '\r') {
+                static const char hex[] = "0123456789ABCDEF";
+                out += '%';
+                out += hex[static_cast<unsigned char>(c) >> 4];
+                out += hex[static_cast<unsigned char>(c) & 0xF];
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    // Inverse of path_component(); false on a malformed escape
+    static bool key_from_path(std::string_view component, std::string& key) {
+        key.clear();
+        for (size_t i = 0; i < component.size(); ++i) {
+            if (component[i] != '%') {
+                key += component[i];
+                continue;
+            }
+            unsigned value = 0;
+            if (component.size() - i < 3) return false;
+            auto result = std::from_chars(component.data() + i + 1, component.data() + i + 3, value, 16);
+            if (result.ec != std::errc() || result.ptr != component.data() + i + 3) return false;
+            key += static_cast<char>(value);
+            i += 2;
+        }
+        return true;
+    }
+
+    static bool item_index(std::string_view key, size_t& index) {
+        if (key.size() <= 4 || key.compare(0, 4, "item") != 0) return false;
+        const char* last = key.data() + key.size();
+        auto result = std::from_chars(key.data() + 4, last, index);
+        return result.ec == std::errc() && result.ptr == last;
+    }
 
     // --- to_ini implementations ---
+    // Output is written directly in declaration order. A section holds the text
+    // values of one object; nested reflected members, maps, and containers of those
+    // get a section of their own named by the dotted path ([parent.child]),
+    // written after the parent's keys.
+
+    // Types written as a subsection instead of a key
+    template <typename T>
+    static constexpr bool is_section() {
+        if constexpr (Meta::has_reflection<T>::value || Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value) return true;
+        else if constexpr (Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value) return is_section<typename T::value_type>();
+        else return false;
+    }
+
+    template <typename T>
+    static void write_section(std::string& out, std::string& path, const T& val, const WriteOptions& options) {
+        out += '[';
+        out += path;
+        out += "]\n";
+        to_ini(val, out, options);
+        if (!options.is_compact()) out += '\n';
+        write_subsections(out, path, val, options);
+    }
+
+    // Writes the subsection path.name; path is restored afterwards
+    template <typename V>
+    static void write_child(std::string& out, std::string& path, std::string_view name, const V& val, const WriteOptions& options) {
+        const size_t size = path.size();
+        path += '.';
+        path += name;
+        write_section(out, path, val, options);
+        path.resize(size);
+    }
+
+    template <typename T>
+    static void write_subsections(std::string& out, std::string& path, const T& val, const WriteOptions& options) {
+        if constexpr (Meta::has_reflection<T>::value) {
+            Ordered::visit_members(val, options, [&](const char* name, const auto& member) {
+                using M = typename std::decay<decltype(member)>::type;
+                if constexpr (is_section<M>()) write_child(out, path, name, member, options);
+            });
+        } else if constexpr (Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value) {
+            if constexpr (is_section<typename T::mapped_type>()) {
+                Ordered::for_each_entry(val, options, [&](const auto& key, const auto& value) {
+                    write_child(out, path, path_component(val_to_string(key)), value, options);
+                });
+            }
+        } else if constexpr (Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value) {
+            if constexpr (is_section<typename T::value_type>()) {
+                char buf[4 + Number::kBufferSize];
+                size_t i = 0;
+                for (const auto& item : val) write_child(out, path, item_key(buf, i++), item, options);
+            }
+        }
+    }
+
+    static void put(std::string& out, std::string_view key, std::string_view value) {
+        out += key;
+        out += '=';
+        out += value;
+        out += '\n';
+    }
 
     // Reflected Types
     template <typename T>
     static typename std::enable_if<Meta::has_reflection<T>::value, void>::type
-    to_ini(const T& obj, inipp::Ini<char>::Section& section) {
-        Meta::visit_members(obj, [&](const char* name, const auto& member) {
-            section[name] = val_to_string(member);
+    to_ini(const T& obj, std::string& out, const WriteOptions& options) {
+        Ordered::visit_members(obj, options, [&](const char* name, const auto& member) {
+            using M = typename std::decay<decltype(member)>::type;
+            if constexpr (!is_section<M>()) put(out, name, val_to_string(member, options));
         });
     }
 
     // Basic Types
     template <typename T>
     static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, void>::type
-    to_ini(const T& val, inipp::Ini<char>::Section& section) {
-        section["value"] = val_to_string(val);
+    to_ini(const T& val, std::string& out, const WriteOptions& options) {
+        put(out, "value", val_to_string(val, options));
     }
     
-    static void to_ini(const std::string& val, inipp::Ini<char>::Section& section) {
-        section["value"] = val;
+    static void to_ini(const std::string& val, std::string& out, const WriteOptions&) {
+        put(out, "value", val);
     }
 
 #ifdef O_SERIALIZE_USE_QT
-    static void to_ini(const QString& val, inipp::Ini<char>::Section& section) {
-        section["value"] = val.toStdString();
+    static void to_ini(const QString& val, std::string& out, const WriteOptions&) {
+        put(out, "value", val.toStdString());
     }
 
     // Qt Smart Pointers (flattened if possible, but INI doesn't support nesting well)
     // We treat smart pointer content as the value.
     template <typename T>
     static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value, void>::type
-    to_ini(const T& ptr, inipp::Ini<char>::Section& section) {
+    to_ini(const T& ptr, std::string& out, const WriteOptions& options) {
         if (ptr) {
-            to_ini(*ptr, section);
+            to_ini(*ptr, out, options);
         }
     }
 
     // QPair (Key-Value style if possible? No, QPair is just 2 values. "first=val1, second=val2")
     template <typename T>
     static typename std::enable_if<Traits::is_qpair<T>::value, void>::type
-    to_ini(const T& pair, inipp::Ini<char>::Section& section) {
-        section["first"] = val_to_string(pair.first);
-        section["second"] = val_to_string(pair.second);
+    to_ini(const T& pair, std::string& out, const WriteOptions& options) {
+        put(out, "first", val_to_string(pair.first, options));
+        put(out, "second", val_to_string(pair.second, options));
     }
 #endif
 
     // STL Map (Key must be string-like)
     template <typename T>
     static typename std::enable_if<Traits::is_stl_map<T>::value, void>::type
-    to_ini(const T& map, inipp::Ini<char>::Section& section) {
-        for (const auto& pair : map) {
-            section[pair.first] = val_to_string(pair.second);
+    to_ini(const T& map, std::string& out, const WriteOptions& options) {
+        if constexpr (!is_section<typename T::mapped_type>()) {
+            Ordered::for_each_entry(map, options, [&](const auto& key, const auto& value) {
+                put(out, key, val_to_string(value, options));
+            });
         }
     }
 
@@ -117,29 +284,63 @@ private:
     // Qt Map
     template <typename T>
     static typename std::enable_if<Traits::is_qt_map<T>::value, void>::type
-    to_ini(const T& map, inipp::Ini<char>::Section& section) {
-        auto it = map.begin();
-        while (it != map.end()) {
-            section[val_to_string(it.key())] = val_to_string(it.value());
-            ++it;
+    to_ini(const T& map, std::string& out, const WriteOptions& options) {
+        if constexpr (!is_section<typename T::mapped_type>()) {
+            Ordered::for_each_entry(map, options, [&](const auto& key, const auto& value) {
+                put(out, val_to_string(key), val_to_string(value, options));
+            });
         }
     }
 #endif
 
     // STL/Qt Container (Vector/List) - Not standard INI.
-    // We can do: item1=val, item2=val...
+    // We can do: item0=val, item1=val...
     template <typename T>
     static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, void>::type
-    to_ini(const T& container, inipp::Ini<char>::Section& section) {
-        int i = 0;
-        for (const auto& item : container) {
-            section["item" + std::to_string(i++)] = val_to_string(item);
+    to_ini(const T& container, std::string& out, const WriteOptions& options) {
+        if constexpr (!is_section<typename T::value_type>()) {
+            char buf[4 + Number::kBufferSize];
+            size_t i = 0;
+            for (const auto& item : container) {
+                put(out, item_key(buf, i++), val_to_string(item, options));
+            }
+        }
+    }
+
+    // val_to_string() honouring options.maxDecimalPlaces for floating point values
+    template <typename T>
+    static std::string val_to_string(const T& val, const WriteOptions& options) {
+        if constexpr (std::is_floating_point<T>::value) {
+            char buf[Number::kBufferSize];
+            return std::string(buf, Number::format(buf, buf + sizeof(buf), val, options.maxDecimalPlaces));
+        } else if constexpr (Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value) {
+            std::string out;
+            for (const auto& item : val) {
+                if (!out.empty()) out += ',';
+                out += val_to_string(item, options);
+            }
+            return out;
+        } else {
+            return val_to_string(val);
         }
     }
     
     // --- val_to_string helpers ---
+
+    // Arithmetic and enum types: to_chars into a stack buffer (shortest round-trip for floating point)
     template <typename T>
-    static typename std::enable_if<!Traits::is_stl_container<T>::value && !Traits::is_qt_container<T>::value && !Traits::is_stl_map<T>::value && !Traits::is_qt_map<T>::value, std::string>::type
+    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, std::string>::type
+    val_to_string(const T& val) {
+        char buf[Number::kBufferSize];
+        return std::string(buf, Number::format(buf, buf + sizeof(buf), val));
+    }
+
+    static std::string val_to_string(bool val) { return val ? "1" : "0"; }
+    static std::string val_to_string(char val) { return std::string(1, val); }
+
+    // Any other streamable type
+    template <typename T>
+    static typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value && !Traits::is_stl_container<T>::value && !Traits::is_qt_container<T>::value && !Traits::is_stl_map<T>::value && !Traits::is_qt_map<T>::value, std::string>::type
     val_to_string(const T& val) {
         std::stringstream ss;
         ss << val;
@@ -180,166 +381,253 @@ private:
 #endif
 
     // --- from_ini implementations ---
+    // Every overload returns false when a value could not be converted. Decoding
+    // carries on with the remaining keys, so one bad value does not lose the rest.
 
     // Reflected Types
     template <typename T>
-    static typename std::enable_if<Meta::has_reflection<T>::value>::type
-    from_ini(const inipp::Ini<char>::Section& section, T& obj) {
+    static typename std::enable_if<Meta::has_reflection<T>::value, bool>::type
+    from_ini(const INIReader& reader, const Section& section, T& obj) {
+        bool ok = true;
         Meta::visit_members(obj, [&](const char* name, auto& member) {
-            auto it = section.find(name);
-            if (it != section.end()) {
-                string_to_val(it->second, member);
+            using M = typename std::decay<decltype(member)>::type;
+            if constexpr (is_section<M>()) {
+                if (const Section* child = reader.subsection(section, name)) {
+                    ok = from_ini(reader, *child, member) && ok;
+                }
+            } else if (const std::string_view* value = section.value(name)) {
+                ok = string_to_val(*value, member) && ok;
             }
         });
+        return ok;
+    }
+
+    // Helper to extract value: arithmetic and enum types are parsed in place with from_chars
+    template <typename T>
+    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, bool>::type
+    string_to_val(std::string_view s, T& val) {
+        return Number::parse(s.data(), s.data() + s.size(), val);
     }
 
-    // Helper to extract value
+    // A plain char is stored as the character itself
+    static bool string_to_val(std::string_view s, char& val) {
+        const char* first = s.data();
+        const char* last = first + s.size();
+        Number::trim(first, last);
+        if (first == last) return false;
+        val = *first;
+        return true;
+    }
+
+    // Any other streamable type
     template <typename T>
-    static typename std::enable_if<!Traits::is_stl_container<T>::value && !Traits::is_qt_container<T>::value && !Traits::is_stl_map<T>::value && !Traits::is_qt_map<T>::value, void>::type
-    string_to_val(const std::string& s, T& val) {
-        std::stringstream ss(s);
+    static typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value && !Traits::is_stl_container<T>::value && !Traits::is_qt_container<T>::value && !Traits::is_stl_map<T>::value && !Traits::is_qt_map<T>::value, bool>::type
+    string_to_val(std::string_view s, T& val) {
+        std::stringstream ss{std::string(s)};
         ss >> val;
+        return !ss.fail();
     }
 
     // Map from String (Not supported fully, clear map)
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value, void>::type
-    string_to_val(const std::string&, T& map) {
+    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value, bool>::type
+    string_to_val(std::string_view, T& map) {
         map.clear();
+        return true;
     }
     
-    // Specialization for vector<string> / set / list
+    // Specialization for vector<string> / set / list: comma separated, split in place
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, void>::type
-    string_to_val(const std::string& s, T& container) {
+    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, bool>::type
+    string_to_val(std::string_view s, T& container) {
         container.clear();
-        std::stringstream ss(s);
-        std::string item_str;
-        while (std::getline(ss, item_str, ',')) {
-             typename T::value_type val;
-             string_to_val(item_str, val);
-             add_item(container, val);
+        bool ok = true;
+        while (!s.empty()) {
+            size_t comma = s.find(',');
+            typename T::value_type val;
+            ok = string_to_val(s.substr(0, comma), val) && ok;
+            add_item(container, val);
+            if (comma == std::string_view::npos) break;
+            s.remove_prefix(comma + 1);
         }
+        return ok;
     }
 
-    static void string_to_val(const std::string& s, std::string& val) { val = s; }
+    static bool string_to_val(std::string_view s, std::string& val) { val.assign(s.data(), s.size()); return true; }
 
 #ifdef O_SERIALIZE_USE_QT
-    static void string_to_val(const std::string& s, QString& val) { val = QString::fromStdString(s); }
-    static void string_to_val(const std::string& s, QDate& val) { val = QDate::fromString(QString::fromStdString(s), Qt::ISODate); }
-    static void string_to_val(const std::string& s, QTime& val) { val = QTime::fromString(QString::fromStdString(s), Qt::ISODate); }
-    static void string_to_val(const std::string& s, QDateTime& val) { val = QDateTime::fromString(QString::fromStdString(s), Qt::ISODate); }
-    static void string_to_val(const std::string& s, QColor& val) { val.setNamedColor(QString::fromStdString(s)); }
+    static QString to_qstring(std::string_view s) { return QString::fromUtf8(s.data(), (int)s.size()); }
+
+    static bool string_to_val(std::string_view s, QString& val) { val = to_qstring(s); return true; }
+    static bool string_to_val(std::string_view s, QDate& val) { val = QDate::fromString(to_qstring(s), Qt::ISODate); return true; }
+    static bool string_to_val(std::string_view s, QTime& val) { val = QTime::fromString(to_qstring(s), Qt::ISODate); return true; }
+    static bool string_to_val(std::string_view s, QDateTime& val) { val = QDateTime::fromString(to_qstring(s), Qt::ISODate); return true; }
+    static bool string_to_val(std::string_view s, QColor& val) { val.setNamedColor(to_qstring(s)); return true; }
 #endif
 
     // Basic Types
     template <typename T>
-    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, void>::type
-    from_ini(const inipp::Ini<char>::Section& section, T& val) {
-        auto it = section.find("value");
-        if (it != section.end()) string_to_val(it->second, val);
+    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, bool>::type
+    from_ini(const INIReader&, const Section& section, T& val) {
+        const std::string_view* value = section.value("value");
+        return value ? string_to_val(*value, val) : true;
     }
 
-    static void from_ini(const inipp::Ini<char>::Section& section, std::string& val) {
-        auto it = section.find("value");
-        if (it != section.end()) val = it->second;
+    static bool from_ini(const INIReader&, const Section& section, std::string& val) {
+        if (const std::string_view* value = section.value("value")) val.assign(value->data(), value->size());
+        return true;
     }
 
 #ifdef O_SERIALIZE_USE_QT
-    static void from_ini(const inipp::Ini<char>::Section& section, QString& val) {
-        auto it = section.find("value");
-        if (it != section.end()) val = QString::fromStdString(it->second);
+    static bool from_ini(const INIReader&, const Section& section, QString& val) {
+        if (const std::string_view* value = section.value("value")) val = to_qstring(*value);
+        return true;
     }
 
     // Qt Smart Pointers
     template <typename T>
-    static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value>::type
-    from_ini(const inipp::Ini<char>::Section& section, T& ptr) {
+    static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value, bool>::type
+    from_ini(const INIReader& reader, const Section& section, T& ptr) {
         // Assume QSharedPointer/QScopedPointer
-        create_qt_smart_ptr_ini(ptr, section);
+        return create_qt_smart_ptr_ini(ptr, reader, section);
     }
 
     // Helpers for creating Qt smart pointers (INI)
     template <typename T>
-    static auto create_qt_smart_ptr_ini(QSharedPointer<T>& ptr, const inipp::Ini<char>::Section& section) -> void {
+    static auto create_qt_smart_ptr_ini(QSharedPointer<T>& ptr, const INIReader& reader, const Section& section) -> bool {
         ptr = QSharedPointer<T>::create();
-        from_ini(section, *ptr);
+        return from_ini(reader, section, *ptr);
     }
     
     template <typename T>
-    static auto create_qt_smart_ptr_ini(QScopedPointer<T>& ptr, const inipp::Ini<char>::Section& section) -> void {
+    static auto create_qt_smart_ptr_ini(QScopedPointer<T>& ptr, const INIReader& reader, const Section& section) -> bool {
         ptr.reset(new T());
-        from_ini(section, *ptr);
+        return from_ini(reader, section, *ptr);
     }
     
     template <typename T>
-    static auto create_qt_smart_ptr_ini(QPointer<T>& ptr, const inipp::Ini<char>::Section&) -> void {
+    static auto create_qt_smart_ptr_ini(QPointer<T>& ptr, const INIReader&, const Section&) -> bool {
         ptr = nullptr;
+        return true;
     }
 
     // QPair
     template <typename T>
-    static typename std::enable_if<Traits::is_qpair<T>::value>::type
-    from_ini(const inipp::Ini<char>::Section& section, T& pair) {
-        auto it = section.find("first");
-        if (it != section.end()) string_to_val(it->second, pair.first);
-        
-        it = section.find("second");
-        if (it != section.end()) string_to_val(it->second, pair.second);
+    static typename std::enable_if<Traits::is_qpair<T>::value, bool>::type
+    from_ini(const INIReader& reader, const Section& section, T& pair) {
+        bool ok = true;
+        if (const std::string_view* value = section.value("first")) ok = string_to_val(*value, pair.first) && ok;
+        if (const std::string_view* value = section.value("second")) ok = string_to_val(*value, pair.second) && ok;
+        return ok;
     }
 #endif
 
     // STL/Qt Map
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value>::type
-    from_ini(const inipp::Ini<char>::Section& section, T& map) {
+    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value, bool>::type
+    from_ini(const INIReader& reader, const Section& section, T& map) {
         map.clear();
-        for (const auto& pair : section) {
-            typename T::mapped_type val;
-            string_to_val(pair.second, val);
-            
-            // Handle Key Conversion: INI keys are always std::string.
-            // For std::map<string, ...> -> direct assignment works.
-            // For QMap<QString, ...> -> pair.first (std::string) needs conversion to QString.
-            // For std::map<int, ...> -> string needs conversion to int.
-            
-            insert_map_item(map, pair.first, val);
+        bool ok = true;
+        if constexpr (is_section<typename T::mapped_type>()) {
+            // One subsection per entry, keyed by the last path component
+            std::string key;
+            for (uint32_t index : section.children) {
+                const Section& child = reader.sections()[index];
+                std::string_view leaf = child.leaf();
+                if (leaf.find('%') != std::string_view::npos) {
+                    if (!key_from_path(leaf, key)) {
+                        ok = false;
+                        continue;
+                    }
+                    leaf = key;
+                }
+                typename T::mapped_type val;
+                ok = from_ini(reader, child, val) && ok;
+                insert_map_item(map, leaf, val);
+            }
+        } else {
+            for (const auto& entry : section) {
+                typename T::mapped_type val;
+                ok = string_to_val(entry.value, val) && ok;
+                
+                // Handle Key Conversion: INI keys are string_views into the input.
+                // For std::map<string, ...> -> constructs the std::string key.
+                // For QMap<QString, ...> -> entry.key needs conversion to QString.
+                
+                insert_map_item(map, entry.key, val);
+            }
         }
+        return ok;
     }
     
     // Helper to insert into map (with key conversion)
     template <typename Map, typename Val>
-    static void insert_map_item(Map& map, const std::string& key, const Val& val) {
-        map[key] = val; // Works for std::map<string, ...>
+    static void insert_map_item(Map& map, std::string_view key, const Val& val) {
+        map[typename Map::key_type(key)] = val; // Works for std::map<string, ...>
     }
     
 #ifdef O_SERIALIZE_USE_QT
     template <typename Val>
-    static void insert_map_item(QMap<QString, Val>& map, const std::string& key, const Val& val) {
-        map[QString::fromStdString(key)] = val;
+    static void insert_map_item(QMap<QString, Val>& map, std::string_view key, const Val& val) {
+        map[to_qstring(key)] = val;
     }
     template <typename Val>
-    static void insert_map_item(QHash<QString, Val>& map, const std::string& key, const Val& val) {
-        map[QString::fromStdString(key)] = val;
+    static void insert_map_item(QHash<QString, Val>& map, std::string_view key, const Val& val) {
+        map[to_qstring(key)] = val;
     }
 #endif
 
-    // STL/Qt Container
+    // STL/Qt Container: one scan of the section (or of its subsections, for items
+    // that are sections themselves) collects the itemN keys by index. Items are
+    // decoded in index order; a missing index does not end the list.
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value>::type
-    from_ini(const inipp::Ini<char>::Section& section, T& container) {
+    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, bool>::type
+    from_ini(const INIReader& reader, const Section& section, T& container) {
+        using V = typename T::value_type;
         container.clear();
-        int i = 0;
-        while (true) {
-            std::string key = "item" + std::to_string(i);
-            auto it = section.find(key);
-            if (it == section.end()) break;
-            
-            typename T::value_type val;
-            string_to_val(it->second, val);
-            add_item(container, val);
-            i++;
+        bool ok = true;
+        if constexpr (is_section<V>()) {
+            const auto items = indexed_items(section.children,
+                [&](uint32_t index) { return reader.sections()[index].leaf(); },
+                [](uint32_t index) { return index; });
+            reserve_items(container, items.size(), 0);
+            for (const auto& item : items) {
+                V val;
+                ok = from_ini(reader, reader.sections()[item.second], val) && ok;
+                add_item(container, val);
+            }
+        } else {
+            const auto items = indexed_items(section,
+                [](const INIReader::Entry& entry) { return entry.key; },
+                [](const INIReader::Entry& entry) { return entry.value; });
+            reserve_items(container, items.size(), 0);
+            for (const auto& item : items) {
+                V val;
+                ok = string_to_val(item.second, val) && ok;
+                add_item(container, val);
+            }
+        }
+        return ok;
+    }
+
+    // (index, payload) for every element of range whose key is itemN, in index order
+    template <typename Range, typename Key, typename Payload>
+    static auto indexed_items(const Range& range, Key&& key, Payload&& payload) {
+        std::vector<std::pair<size_t, decltype(payload(*range.begin()))>> items;
+        items.reserve(range.size());
+        bool sorted = true;
+        for (const auto& element : range) {
+            size_t index;
+            if (!item_index(key(element), index)) continue;
+            if (!items.empty() && index < items.back().first) sorted = false;
+            items.emplace_back(index, payload(element));
+        }
+        // Kept in file order, which is already sorted for files we wrote
+        if (!sorted) {
+            std::stable_sort(items.begin(), items.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; });
         }
+        return items;
     }
 
 };
@@ -0,0 +1,221 @@
+#ifndef O_SERIALIZE_INI_READER_H
+#define O_SERIALIZE_INI_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace OSerialize {
+
+// Single-pass INI tokenizer over a contiguous buffer.
+//
+// Keys, values and section names are string_views into the caller's buffer, which
+// must outlive the reader; nothing is copied. Each section indexes its entries in a
+// flat open-addressed hash table and keeps them in file order for iteration.
+//
+// Syntax follows inipp: lines are trimmed, lines starting with ';' are comments,
+// "[name]" opens a section (a repeated header reopens it), "key = value" adds an
+// entry to the current section, keys before the first header go to section "".
+// The first occurrence of a duplicate key wins; malformed lines are counted and
+// otherwise ignored.
+//
+// Dotted section names form a tree: "[app.db]" is a subsection of "[app]". Missing
+// ancestors are created empty, every section lists its direct subsections, and a
+// subsection is looked up by extending the parent's path hash, so nested structs
+// are resolved without building dotted path strings.
+class INIReader {
+public:
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+        uint32_t hash;
+    };
+
+    // Open-addressed table of items with a string_view key and its hash,
+    // iterable in insertion order
+    template <typename Item>
+    class FlatTable {
+    public:
+        using const_iterator = typename std::vector<Item>::const_iterator;
+
+        const_iterator begin() const { return _items.begin(); }
+        const_iterator end() const { return _items.end(); }
+        size_t size() const { return _items.size(); }
+        bool empty() const { return _items.empty(); }
+        const Item& operator[](size_t i) const { return _items[i]; }
+
+        const Item* find(std::string_view key) const { return find(key, hash_of(key)); }
+
+        const Item* find(std::string_view key, uint32_t hash) const {
+            return find_if(hash, [key](const Item& item) { return item.key == key; });
+        }
+
+        // First item with the given hash whose key satisfies match
+        template <typename Match>
+        const Item* find_if(uint32_t hash, Match&& match) const {
+            if (_slots.empty()) return nullptr;
+            const size_t mask = _slots.size() - 1;
+            for (size_t i = hash & mask; _slots[i] != 0; i = (i + 1) & mask) {
+                const Item& item = _items[_slots[i] - 1];
+                if (item.hash == hash && match(item)) return &item;
+            }
+            return nullptr;
+        }
+
+        // Returns the index of the item stored under key, appending a new one if absent
+        size_t insert(std::string_view key, uint32_t hash, bool& inserted) {
+            if ((_items.size() + 1) * 2 > _slots.size()) rehash(_slots.empty() ? 16 : _slots.size() * 2);
+            const size_t mask = _slots.size() - 1;
+            size_t i = hash & mask;
+            for (; _slots[i] != 0; i = (i + 1) & mask) {
+                const Item& item = _items[_slots[i] - 1];
+                if (item.hash == hash && item.key == key) {
+                    inserted = false;
+                    return _slots[i] - 1;
+                }
+            }
+            _items.emplace_back();
+            _items.back().key = key;
+            _items.back().hash = hash;
+            _slots[i] = static_cast<uint32_t>(_items.size());
+            inserted = true;
+            return _items.size() - 1;
+        }
+
+        Item& at(size_t i) { return _items[i]; }
+
+    private:
+        void rehash(size_t capacity) {
+            _slots.assign(capacity, 0);
+            const size_t mask = capacity - 1;
+            for (size_t n = 0; n < _items.size(); ++n) {
+                size_t i = _items[n].hash & mask;
+                while (_slots[i] != 0) i = (i + 1) & mask;
+                _slots[i] = static_cast<uint32_t>(n + 1);
+            }
+        }
+
+        std::vector<Item> _items;
+        std::vector<uint32_t> _slots; // index + 1 into _items, 0 = empty
+    };
+
+    class Section : public FlatTable<Entry> {
+    public:
+        std::string_view key;   // full dotted path
+        uint32_t hash;          // hash_of(key)
+        std::vector<uint32_t> children; // direct subsections, indexes into sections()
+
+        std::string_view name() const { return key; }
+
+        // Last component of the dotted path
+        std::string_view leaf() const {
+            const size_t dot = key.rfind('.');
+            return dot == std::string_view::npos ? key : key.substr(dot + 1);
+        }
+
+        // Value of key, or nullptr if the section has no such key
+        const std::string_view* value(std::string_view k) const {
+            const Entry* entry = find(k);
+            return entry ? &entry->value : nullptr;
+        }
+    };
+
+    INIReader(const char* data, size_t size) { parse(data, data + size); }
+    explicit INIReader(std::string_view text) : INIReader(text.data(), text.size()) {}
+
+    // Section by full dotted path, or nullptr if the document has none
+    const Section* section(std::string_view path) const { return _sections.find(path); }
+
+    // Subsection "<parent>.<name>", or nullptr
+    const Section* subsection(const Section& parent, std::string_view name) const {
+        const uint32_t hash = hash_of(name, hash_of(".", parent.hash));
+        const size_t n = parent.key.size();
+        return _sections.find_if(hash, [&](const Section& s) {
+            return s.key.size() == n + 1 + name.size() && s.key[n] == '.' &&
+                   s.key.compare(0, n, parent.key) == 0 && s.key.compare(n + 1, name.size(), name) == 0;
+        });
+    }
+
+    const FlatTable<Section>& sections() const { return _sections; }
+
+    // Number of lines that were neither blank, comments, headers nor assignments
+    size_t error_count() const { return _errors; }
+
+    // FNV-1a; h continues a previous hash, so hash_of(b, hash_of(a)) == hash_of(a + b)
+    static uint32_t hash_of(std::string_view s, uint32_t h = 2166136261u) {
+        for (unsigned char ch : s) {
+            h ^= ch;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+private:
+    static bool is_space(char ch) {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '\v' || ch == '\f';
+    }
+
+    static std::string_view trimmed(const char* first, const char* last) {
+        while (first != last && is_space(*first)) ++first;
+        while (last != first && is_space(last[-1])) --last;
+        return std::string_view(first, static_cast<size_t>(last - first));
+    }
+
+    void parse(const char* p, const char* end) {
+        if (end - p >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;
+
+        bool inserted = false;
+        // Only a new section header moves the sections, and it re-points current
+        Section* current = &_sections.at(_sections.insert(std::string_view(), hash_of(std::string_view()), inserted));
+
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!eol) eol = end;
+            const std::string_view line = trimmed(p, eol);
+            p = eol + 1;
+
+            if (line.empty() || line.front() == ';') continue;
+
+            if (line.front() == '[') {
+                if (line.back() != ']') {
+                    ++_errors;
+                    continue;
+                }
+                current = &_sections.at(add_section(line.substr(1, line.size() - 2)));
+                continue;
+            }
+
+            const size_t assign = line.find('=');
+            if (assign == 0 || assign == std::string_view::npos) {
+                ++_errors;
+                continue;
+            }
+            const std::string_view key = trimmed(line.data(), line.data() + assign);
+            const std::string_view value = trimmed(line.data() + assign + 1, line.data() + line.size());
+            const size_t index = current->insert(key, hash_of(key), inserted);
+            if (inserted) current->at(index).value = value;
+            else ++_errors;
+        }
+    }
+
+    // Inserts the section and any missing ancestors, linking each new one to its parent
+    size_t add_section(std::string_view path) {
+        bool inserted = false;
+        const size_t index = _sections.insert(path, hash_of(path), inserted);
+        const size_t dot = path.rfind('.');
+        if (inserted && dot != std::string_view::npos) {
+            const size_t parent = add_section(path.substr(0, dot));
+            _sections.at(parent).children.push_back(static_cast<uint32_t>(index));
+        }
+        return index;
+    }
+
+    FlatTable<Section> _sections;
+    size_t _errors = 0;
+};
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_INI_READER_H
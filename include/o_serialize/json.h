@@ -3,16 +3,26 @@
 
 #include "o_serialize/base.h"
 #include "o_serialize/o_serialize.h"
+#include "o_serialize/file_io.h"
+#include "o_serialize/number.h"
+#include "o_serialize/options.h"
+#include "o_serialize/sink.h"
+#include "o_serialize/stats.h"
 #include "rapidjson/document.h"
+#include "rapidjson/pointer.h"
+#include "rapidjson/reader.h"
 #include "rapidjson/writer.h"
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/stringbuffer.h"
-#include "rapidjson/istreamwrapper.h"
-#include "rapidjson/ostreamwrapper.h"
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/filewritestream.h"
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <iostream>
-#include <fstream>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 #ifdef O_SERIALIZE_USE_QT
 #include <QDateTime>
@@ -28,27 +38,95 @@
 #include <QLineF>
 #include <QColor>
 #include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborValue>
+#endif
+#include <cmath>
 #endif
 
 namespace OSerialize {
 
 class JSON {
+    // LazyView 的成员用到，定义在下方 private 部分
+    struct MemberSpan;
+
 public:
+    // 库内使用的 rapidjson 类型。默认与 rapidjson::Document 等相同；开启
+    // O_SERIALIZE_ENABLE_STATS 时底层分配器换成 Stats::CountingAllocator，
+    // 内存池、StringBuffer 与 Reader / Writer 栈的 malloc 也计入 Stats
+#ifdef O_SERIALIZE_ENABLE_STATS
+    typedef Stats::CountingAllocator BaseAllocator;
+#else
+    typedef rapidjson::CrtAllocator BaseAllocator;
+#endif
+    typedef rapidjson::MemoryPoolAllocator<BaseAllocator> Allocator;
+    typedef rapidjson::GenericValue<rapidjson::UTF8<>, Allocator> Value;
+    typedef rapidjson::GenericDocument<rapidjson::UTF8<>, Allocator, BaseAllocator> Document;
+    typedef rapidjson::GenericStringBuffer<rapidjson::UTF8<>, BaseAllocator> StringBuffer;
+    typedef rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, BaseAllocator> Reader;
+    typedef rapidjson::GenericPointer<Value, BaseAllocator> Pointer;
+
+    // 不带选项时输出紧凑格式
     template <typename T>
     static std::string obj_to_string(const T& obj) {
-        rapidjson::Document doc;
-        rapidjson::Value val = to_json(obj, doc.GetAllocator());
-        
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-        val.Accept(writer);
-        return buffer.GetString();
+        return obj_to_string(obj, WriteOptions::compact());
+    }
+
+    // 返回新字符串时仍经由 StringBuffer：它用 realloc 扩容，大块内存可原地增长，
+    // 比 std::string 每次翻倍都复制已写内容更快，最后按长度复制一次。
+    // 不按 size_hint 预分配：对 DOM 逐节点估算长度的遍历比它省下的几次扩容更贵
+    template <typename T>
+    static std::string obj_to_string(const T& obj, const WriteOptions& options) {
+        O_SERIALIZE_STATS_SCOPE();
+        StringBuffer buffer;
+        obj_to_sink(obj, buffer, options);
+        O_SERIALIZE_STATS_OUTPUT(buffer.GetSize());
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
+    // 写进调用方复用的字符串：原内容被替换，容量保留，稳定状态下不分配内存，
+    // 也没有从中间缓冲区复制的一步
+    template <typename T>
+    static void obj_to_string(const T& obj, std::string& out, const WriteOptions& options = WriteOptions::compact()) {
+        O_SERIALIZE_STATS_SCOPE();
+        StringSink sink(out);
+        obj_to_sink(obj, sink, options);
+        sink.finish();
+        O_SERIALIZE_STATS_OUTPUT(out.size());
+    }
+
+    // 写进固定大小的缓冲区（不写结尾的 '\0'）。返回完整输出所需的字节数，
+    // 大于 size 表示缓冲区不够，超出部分被丢弃，可按返回值扩大后重试
+    template <typename T>
+    static size_t obj_to_buffer(const T& obj, char* data, size_t size, const WriteOptions& options = WriteOptions::compact()) {
+        O_SERIALIZE_STATS_SCOPE();
+        BufferSink sink(data, size);
+        obj_to_sink(obj, sink, options);
+        O_SERIALIZE_STATS_OUTPUT(sink.size());
+        return sink.required();
+    }
+
+    // 写到任意 rapidjson 输出流（StringSink、BufferSink、IovecSink 或自定义流）
+    template <typename T, typename Sink>
+    static void obj_to_sink(const T& obj, Sink& sink, const WriteOptions& options = WriteOptions::compact()) {
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
+        Value val = to_json(obj, doc.GetAllocator());
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
+        write_value(val, sink, options);
     }
 
     template <typename T>
     static T string_to_obj(const std::string& json) {
-        rapidjson::Document doc;
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
         doc.Parse(json.c_str());
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
         
         T obj;
         if (doc.HasParseError()) {
@@ -60,43 +138,853 @@ public:
         return obj;
     }
 
+    // 按需解码的只读视图：构造时只用 SAX 扫描一遍，记下顶层对象中每个反射成员
+    // 对应的文本区间，不建 DOM；get(&T::member) 第一次调用时才把该区间解析并解码
+    // 到成员，之后返回缓存。只取几个字段时，其余成员（如大数组）不会被构造。
+    // 文本被复制一份由视图持有；缓存不加锁，同一视图不能被多个线程同时访问
+    //
+    //   JSON::LazyView<Order> view(json);
+    //   if (view.is_valid() && view.get(&Order::id) == 42) { ... }
     template <typename T>
-    static bool obj_to_file(const T& obj, const std::string& filepath) {
-        rapidjson::Document doc;
-        rapidjson::Value val = to_json(obj, doc.GetAllocator());
-        
-        std::ofstream ofs(filepath);
-        if (!ofs.is_open()) return false;
-        
-        rapidjson::OStreamWrapper osw(ofs);
-        rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(osw);
-        val.Accept(writer);
+    class LazyView {
+        static_assert(Meta::has_reflection<T>::value, "LazyView requires a type registered with O_SERIALIZE_STRUCT");
+
+    public:
+        explicit LazyView(std::string json) : _json(std::move(json)), _spans(member_spans<T>()) {
+            _decoded.assign(_spans.size(), false);
+            _valid = index_members(_json.c_str(), _spans);
+        }
+
+        // 文本是否为合法 JSON 且顶层是对象
+        bool is_valid() const { return _valid; }
+
+        // 成员是否出现在文本中
+        template <typename M>
+        bool has(M T::*field) const {
+            const size_t index = index_of(field);
+            return index < _spans.size() && _spans[index].found;
+        }
+
+        // 解码并缓存成员；文本中没有该成员时返回默认值
+        template <typename M>
+        const M& get(M T::*field) {
+            const size_t index = index_of(field);
+            if (_valid && index < _spans.size() && !_decoded[index]) {
+                _decoded[index] = true;
+                const MemberSpan& span = _spans[index];
+                if (span.found) decode_range(_json.c_str(), span.begin, span.end, _obj.*field);
+            }
+            return _obj.*field;
+        }
+
+        // 解码全部成员，结果与 string_to_obj 相同
+        const T& obj() {
+            Meta::visit_fields<T>([&](const char*, auto field) { get(field); });
+            return _obj;
+        }
+
+    private:
+        template <typename M>
+        static size_t index_of(M T::*field) {
+            size_t index = 0;
+            size_t found = static_cast<size_t>(-1);
+            Meta::visit_fields<T>([&](const char*, auto candidate) {
+                if constexpr (std::is_same<decltype(candidate), M T::*>::value) {
+                    if (found == static_cast<size_t>(-1) && candidate == field) found = index;
+                }
+                ++index;
+            });
+            return found;
+        }
+
+        std::string _json;
+        std::vector<MemberSpan> _spans;
+        std::vector<bool> _decoded;
+        T _obj{};
+        bool _valid = false;
+    };
+
+    // 只读取 fields 选中的顶层成员，其余成员保持默认值。未选中成员的值在 SAX
+    // 扫描中直接跳过（数字不做转换），不建 DOM 节点，也不调用 from_json
+    //
+    //   auto order = JSON::string_to_obj<Order>(json, FieldMask<Order>(&Order::id, &Order::customer));
+    template <typename T>
+    static T string_to_obj(const std::string& json, const FieldMask<T>& fields) {
+        O_SERIALIZE_STATS_SCOPE();
+        T obj;
+        std::vector<MemberSpan> spans = member_spans<T>();
+        for (size_t i = 0; i < spans.size(); ++i) spans[i].wanted = fields.contains(i);
+        if (!index_members(json.c_str(), spans)) return obj;
+
+        size_t index = 0;
+        Meta::visit_members(obj, [&](const char*, auto& member) {
+            const MemberSpan& span = spans[index++];
+            if (span.found) decode_range(json.c_str(), span.begin, span.end, member);
+        });
+        return obj;
+    }
+
+    // --- 直接对接调用方已有的 rapidjson 值与 SAX 事件，省去文本往返 ---
+
+    // 从调用方的 JSON::Value / Document 解码；json 中没有的成员保持原值。默认构建中
+    // 它们就是 rapidjson::Value / Document，开启统计时则必须用 JSON:: 下的类型
+    template <typename T>
+    static void from_value(const Value& json, T& obj) {
+        O_SERIALIZE_STATS_SCOPE();
+        from_json(json, obj);
+    }
+
+    // 转为用调用方分配器分配的 JSON::Value，例如插入已有 JSON::Document：
+    //   doc.AddMember("order", JSON::to_value(order, doc.GetAllocator()), doc.GetAllocator());
+    // 结果自带全部字符串，不引用 obj，可以比 obj 活得更久
+    template <typename T>
+    static Value to_value(const T& obj, Allocator& allocator) {
+        O_SERIALIZE_STATS_SCOPE();
+        Value val = to_json(obj, allocator);
+        own_strings(val, allocator);
+        return val;
+    }
+
+    // SAX 输入：generator(handler) 向 handler 发出恰好一个完整值的事件（rapidjson
+    // Reader、其他 Value 的 Accept 等），不经过文本直接解码。generator 返回 false
+    // 时返回 false，obj 不变。这不是流式解码：事件先经 Document::Populate 建成
+    // 完整的 DOM，再由 from_json 解码，内存占用与 string_to_obj 相同
+    //   JSON::from_sax([&](auto& handler) { return reader.Parse(stream, handler); }, obj);
+    template <typename T, typename Generator>
+    static bool from_sax(Generator&& generator, T& obj) {
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
+        bool ok = false;
+        auto g = [&](Document& handler) {
+            ok = static_cast<bool>(generator(handler));
+            return ok;
+        };
+        doc.Populate(g);
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
+        if (!ok) return false;
+        from_json(doc, obj);
         return true;
     }
 
+    // SAX 输出：把 obj 作为事件序列交给任意 rapidjson Handler（调用方的 Writer、
+    // 过滤器等）；返回 handler 的结果
+    template <typename T, typename Handler>
+    static bool to_sax(const T& obj, Handler& handler) {
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
+        Value val = to_json(obj, doc.GetAllocator());
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
+        return val.Accept(handler);
+    }
+
+#ifdef O_SERIALIZE_USE_QT
+    // --- 与 Qt JSON 类型直接互转，不经过 QJsonDocument::toJson 再解析的文本往返 ---
+    // QJsonValue 与 rapidjson 值逐节点转换，成员的编解码仍由 from_json / to_json
+    // 完成，支持的类型（QString、QDateTime、QColor、几何类型等）与文本接口一致
+
+    // QJsonObject / QJsonArray 可隐式转换为 QJsonValue；json 中没有的成员保持原值
+    template <typename T>
+    static void from_qjson(const QJsonValue& json, T& obj) {
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
+        Value val = qjson_to_value(json, doc.GetAllocator());
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
+        from_json(val, obj);
+    }
+
+    template <typename T>
+    static void from_qjson(const QJsonDocument& json, T& obj) {
+        if (json.isObject()) from_qjson(QJsonValue(json.object()), obj);
+        else if (json.isArray()) from_qjson(QJsonValue(json.array()), obj);
+    }
+
+    // 超过 2^53 的整数可能丢失精度，见 value_to_qjson
+    template <typename T>
+    static QJsonValue to_qjson(const T& obj) {
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
+        Value val = to_json(obj, doc.GetAllocator());
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
+        return value_to_qjson(val);
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    // QCborValue 经 Qt 自身的 toJsonValue / fromJsonValue 转换，同样不经过文本
+    template <typename T>
+    static void from_qcbor(const QCborValue& cbor, T& obj) {
+        from_qjson(cbor.toJsonValue(), obj);
+    }
+
+    template <typename T>
+    static QCborValue to_qcbor(const T& obj) {
+        return QCborValue::fromJsonValue(to_qjson(obj));
+    }
+#endif
+#endif
+
+    // extract 的一个目标：JSON Pointer（RFC 6901，如 "/orders/2/id"）与解码结果
+    template <typename T>
+    struct PointerTarget {
+        const char* pointer;
+        T& out;
+    };
+
+    template <typename T>
+    static PointerTarget<T> at(const char* pointer, T& out) { return PointerTarget<T>{pointer, out}; }
+
+    // 只扫描一遍文本，把每个 pointer 指向的值用 from_json 解码到 out，返回找到的个数；
+    // 未找到的目标保持原值。所有路径都有结果后立即停止解析，文本的剩余部分不再读取
+    // （也不再校验）。与 rapidjson::Pointer::Get 一致，重复的键只看第一个
+    //
+    //   int id = 0; std::string user;
+    //   JSON::extract(json, JSON::at("/id", id), JSON::at("/request/user", user));
+    template <typename... T>
+    static size_t extract(const std::string& json, PointerTarget<T>... targets) {
+        O_SERIALIZE_STATS_SCOPE();
+        std::vector<PointerSpan> spans;
+        spans.reserve(sizeof...(T));
+        (spans.emplace_back(targets.pointer), ...);
+        if (!scan_pointers(json.c_str(), spans)) return 0;
+
+        size_t index = 0;
+        size_t found = 0;
+        auto decode = [&](auto& target) {
+            const PointerSpan& span = spans[index++];
+            if (!span.found) return;
+            decode_range(json.c_str(), span.begin, span.end, target.out);
+            ++found;
+        };
+        (decode(targets), ...);
+        return found;
+    }
+
+    // 单个路径；未找到时返回默认值
+    template <typename T>
+    static T extract(const std::string& json, const char* pointer) {
+        T out{};
+        extract(json, at(pointer, out));
+        return out;
+    }
+
+    // 写文件：Linux/macOS 上经由 4K 对齐的大缓冲区直接 write() 到文件描述符，
+    // options.directIO / options.preallocate 控制 O_DIRECT 与 fallocate 预分配
+    template <typename T>
+    static bool obj_to_file(const T& obj, const std::string& filepath, const WriteOptions& options = WriteOptions::pretty()) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = FdWriteStream::open(filepath, options);
+        if (fd < 0) return false;
+        bool ok = obj_to_fd(obj, fd, options);
+        return ::close(fd) == 0 && ok;
+#else
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
+        Value val = to_json(obj, doc.GetAllocator());
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
+
+        FILE* file = std::fopen(filepath.c_str(), "wb");
+        if (!file) return false;
+        std::vector<char> buffer(256 * 1024);
+        rapidjson::FileWriteStream stream(file, buffer.data(), buffer.size());
+        write_value(val, stream, options);
+        stream.Flush();
+        O_SERIALIZE_STATS_OUTPUT(static_cast<size_t>(std::ftell(file)));
+        bool ok = !std::ferror(file);
+        return std::fclose(file) == 0 && ok;
+#endif
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // 写到已打开的文件描述符（不负责关闭）
+    template <typename T>
+    static bool obj_to_fd(const T& obj, int fd, const WriteOptions& options = WriteOptions::pretty()) {
+        O_SERIALIZE_STATS_SCOPE();
+        FdWriteStream stream(fd);
+        obj_to_sink(obj, stream, options);
+        bool ok = stream.finish();
+        O_SERIALIZE_STATS_OUTPUT(stream.written());
+        return ok;
+    }
+
+    // 写进 IovecSink 的分块缓冲区，再由 sink.iov() / sink.write_to(fd) 交给
+    // writev / sendmsg 发送；大消息不会因缓冲区扩容而整体复制。
+    // 追加在 sink 已有内容之后，新消息前先调用 sink.reset()
+    template <typename T>
+    static void obj_to_iovec(const T& obj, IovecSink& sink, const WriteOptions& options = WriteOptions::compact()) {
+        O_SERIALIZE_STATS_SCOPE();
+        const size_t start = sink.size();
+        obj_to_sink(obj, sink, options);
+        O_SERIALIZE_STATS_OUTPUT(sink.size() - start);
+        (void)start;
+    }
+#endif
+
+    // 紧凑 JSON 输出（WriteOptions::compact()）的精确字节数：只遍历对象，不构造 DOM。
+    // 整数、bool、字符串与键名（含转义）按位数与转义规则计算，浮点数用写出时
+    // 同一个 rapidjson dtoa 格式化后取长度；反射遍历未覆盖的类型（Qt 几何类型等）
+    // 先转为 DOM 再计算。供调用方为 obj_to_buffer 的固定缓冲或共享内存槽位定长；
+    // 它本身要遍历一遍对象，obj_to_string 不用它预分配
+    template <typename T>
+    static size_t size_hint(const T& obj) {
+        if constexpr (Meta::has_reflection<T>::value) {
+            size_t size = 2;
+            size_t count = 0;
+            Meta::visit_members(obj, [&](const char* name, const auto& member) {
+                size += quoted_size(name, std::strlen(name)) + 1 + size_hint(member);
+                ++count;
+            });
+            return size + (count ? count - 1 : 0);
+        } else if constexpr (std::is_same<T, bool>::value) {
+            return obj ? 4 : 5;
+        } else if constexpr (std::is_integral<T>::value) {
+            return digit_count(obj);
+        } else if constexpr (std::is_enum<T>::value) {
+            return digit_count(static_cast<int>(obj));
+        } else if constexpr (std::is_floating_point<T>::value) {
+            if constexpr (std::is_same<T, float>::value) return double_size(Number::widen(obj));
+            else return double_size(static_cast<double>(obj));
+        } else if constexpr (std::is_same<T, std::string>::value) {
+            return quoted_size(obj.data(), obj.size());
+        } else if constexpr (std::is_same<T, const char*>::value || std::is_same<T, char*>::value) {
+            return quoted_size(obj, std::strlen(obj));
+        } else if constexpr (Traits::is_smart_ptr<T>::value) {
+            return obj ? size_hint(*obj) : 4;
+        } else if constexpr (Traits::is_variant<T>::value) {
+            return std::visit([](const auto& val) { return size_hint(val); }, obj);
+        } else if constexpr (Traits::is_pair<T>::value) {
+            return 20 + size_hint(obj.first) + size_hint(obj.second); // {"first":,"second":}
+        } else if constexpr (Traits::is_tuple<T>::value) {
+            size_t size = 2 + (std::tuple_size<T>::value ? std::tuple_size<T>::value - 1 : 0);
+            std::apply([&](const auto&... items) { ((size += size_hint(items)), ...); }, obj);
+            return size;
+        } else if constexpr (Traits::is_stl_container<T>::value) {
+            size_t size = 2 + (obj.empty() ? 0 : obj.size() - 1);
+            for (const auto& item : obj) size += size_hint(item);
+            return size;
+        } else if constexpr (Traits::is_stl_map<T>::value && std::is_same<typename T::key_type, std::string>::value) {
+            size_t size = 2 + (obj.empty() ? 0 : obj.size() - 1);
+            for (const auto& pair : obj) size += quoted_size(pair.first.data(), pair.first.size()) + 1 + size_hint(pair.second);
+            return size;
+        } else {
+            Document doc;
+            return value_size(to_json(obj, doc.GetAllocator()));
+        }
+    }
+
     template <typename T>
     static T file_to_obj(const std::string& filepath) {
         T obj;
-        std::ifstream ifs(filepath);
-        if (!ifs.is_open()) {
+        try_file_to_obj(filepath, obj);
+        return obj;
+    }
+
+    // 不抛异常的 file_to_obj()：文件无法打开或解析失败时返回 false，obj 保持不变
+    template <typename T>
+    static bool try_file_to_obj(const std::string& filepath, T& obj) {
+        O_SERIALIZE_STATS_SCOPE();
+        Document doc;
+#if defined(__unix__) || defined(__APPLE__)
+        // 直接解析映射到内存的文件内容，不经过流缓冲
+        MappedFile file(filepath);
+        if (!file.is_open()) {
             std::cerr << "Cannot open file: " << filepath << std::endl;
-            return obj;
+            return false;
         }
-        
-        rapidjson::IStreamWrapper isw(ifs);
-        rapidjson::Document doc;
-        doc.ParseStream(isw);
+        doc.Parse(file.data(), file.size());
+#else
+        FILE* file = std::fopen(filepath.c_str(), "rb");
+        if (!file) {
+            std::cerr << "Cannot open file: " << filepath << std::endl;
+            return false;
+        }
+        std::vector<char> buffer(256 * 1024);
+        rapidjson::FileReadStream stream(file, buffer.data(), buffer.size());
+        doc.ParseStream(stream);
+        std::fclose(file);
+#endif
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
         
         if (doc.HasParseError()) {
             std::cerr << "JSON Parse Error" << std::endl;
-            return obj;
+            return false;
         }
         
         from_json(doc, obj);
-        return obj;
+        return true;
     }
 
 private:
+    // --- 顶层成员索引（LazyView / 字段投影） ---
+
+    // 反射成员在 JSON 文本中的值区间 [begin, end)；wanted 为 false 的成员不记录
+    struct MemberSpan {
+        const char* name;
+        size_t nameLength;
+        bool wanted = true;
+        bool found = false;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    template <typename T>
+    static std::vector<MemberSpan> member_spans() {
+        std::vector<MemberSpan> spans;
+        Meta::visit_fields<T>([&](const char* name, auto) { spans.push_back(MemberSpan{name, std::strlen(name)}); });
+        return spans;
+    }
+
+    // 输入流。rapidjson 会把 StringStream 复制到局部变量里读，回调时原对象的
+    // 位置还没更新；这个类型没有 copyOptimization，回调里的 Tell() 才准确
+    struct Cursor {
+        typedef char Ch;
+        const char* src;
+        const char* head;
+        Ch Peek() const { return *src; }
+        Ch Take() { return *src++; }
+        size_t Tell() const { return static_cast<size_t>(src - head); }
+        Ch* PutBegin() { return nullptr; }
+        void Put(Ch) {}
+        void Flush() {}
+        size_t PutEnd(Ch*) { return 0; }
+    };
+
+    // SAX 处理器：只跟踪嵌套深度，记录顶层成员值的起止位置
+    struct MemberIndexer : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, MemberIndexer> {
+        MemberIndexer(const Cursor& stream, std::vector<MemberSpan>& spans) : stream(stream), spans(spans), current(spans.size()) {}
+
+        bool Default() { return end_value(); }
+        bool Key(const char* str, rapidjson::SizeType length, bool) {
+            if (depth != 1) return true;
+            current = spans.size();
+            for (size_t i = 0; i < spans.size(); ++i) {
+                // 与 from_json 一致：重复的键取第一个
+                if (spans[i].wanted && !spans[i].found && spans[i].nameLength == length && std::memcmp(spans[i].name, str, length) == 0) {
+                    current = i;
+                    break;
+                }
+            }
+            if (current < spans.size()) {
+                // 区间从键后的 ':' 之后开始，值前的空白交给 Parse 跳过
+                const char* p = stream.src;
+                while (*p != ':') ++p;
+                spans[current].begin = static_cast<size_t>(p + 1 - stream.head);
+            }
+            return true;
+        }
+        bool StartObject() {
+            if (depth == 0) isObject = true;
+            ++depth;
+            return true;
+        }
+        bool EndObject(rapidjson::SizeType) {
+            --depth;
+            return end_value();
+        }
+        bool StartArray() {
+            ++depth;
+            return true;
+        }
+        bool EndArray(rapidjson::SizeType) {
+            --depth;
+            return end_value();
+        }
+
+        bool end_value() {
+            if (depth == 1 && current < spans.size()) {
+                spans[current].end = stream.Tell();
+                spans[current].found = true;
+                current = spans.size();
+            }
+            return true;
+        }
+
+        const Cursor& stream;
+        std::vector<MemberSpan>& spans;
+        size_t current;
+        int depth = 0;
+        bool isObject = false;
+    };
+
+    // 扫描整个文本（同时校验格式），填写 spans；文本非法或顶层不是对象时返回 false。
+    // 数字按字符串交给处理器，跳过的成员不做数值转换
+    static bool index_members(const char* json, std::vector<MemberSpan>& spans) {
+        Cursor stream{json, json};
+        MemberIndexer indexer(stream, spans);
+        Reader reader;
+        if (reader.Parse<rapidjson::kParseNumbersAsStringsFlag>(stream, indexer).IsError()) {
+            std::cerr << "JSON Parse Error" << std::endl;
+            return false;
+        }
+        return indexer.isObject;
+    }
+
+    // --- JSON Pointer 提取（extract） ---
+
+    struct PointerSpan {
+        explicit PointerSpan(const char* source) : pointer(source) {}
+
+        Pointer pointer;
+        size_t matched = 0;     // 当前路径与 pointer 前缀相同的层数
+        bool capturing = false;
+        bool found = false;
+        bool done = false;      // 已找到，或已确定不会出现
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    // SAX 处理器：维护当前路径，记录各 pointer 指向的值的文本区间；
+    // 全部有结果后返回 false 让 Reader 提前停止
+    struct PointerScanner : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, PointerScanner> {
+        struct Frame {
+            bool isArray;
+            rapidjson::SizeType count;
+            std::string key;
+        };
+
+        PointerScanner(const Cursor& stream, std::vector<PointerSpan>& spans) : stream(stream), spans(spans) {
+            for (PointerSpan& span : spans) {
+                if (!span.pointer.IsValid()) resolve(span);
+            }
+        }
+
+        bool Default() {
+            begin_value();
+            return end_value();
+        }
+        bool Key(const char* str, rapidjson::SizeType length, bool) {
+            // 只有下一个值可能在某个 pointer 的路径上时才保存键
+            const size_t depth = frames.size();
+            bool wanted = false;
+            for (const PointerSpan& span : spans) {
+                wanted = wanted || (!span.done && span.matched + 1 >= depth && span.pointer.GetTokenCount() >= depth);
+            }
+            if (wanted) frames.back().key.assign(str, length);
+            else frames.back().key.clear();
+            mark = stream.Tell();
+            return true;
+        }
+        bool StartObject() { return start_container(false); }
+        bool StartArray() { return start_container(true); }
+        bool EndObject(rapidjson::SizeType) { return end_container(); }
+        bool EndArray(rapidjson::SizeType) { return end_container(); }
+
+        bool start_container(bool isArray) {
+            begin_value();
+            frames.push_back(Frame{isArray, 0, std::string()});
+            mark = stream.Tell();
+            return true;
+        }
+
+        bool end_container() {
+            frames.pop_back();
+            // 路径经过这个容器却没找到：重复的键只看第一个，之后不会再出现
+            const size_t depth = frames.size();
+            for (PointerSpan& span : spans) {
+                if (!span.done && span.matched >= depth && span.pointer.GetTokenCount() > depth) resolve(span);
+            }
+            return end_value();
+        }
+
+        // 值开始：更新每个 pointer 的匹配层数，完全匹配时从 mark 开始记录
+        void begin_value() {
+            const size_t depth = frames.size();
+            rapidjson::SizeType index = 0;
+            if (depth > 0 && frames.back().isArray) index = frames.back().count++;
+            for (PointerSpan& span : spans) {
+                if (span.done) continue;
+                const size_t tokens = span.pointer.GetTokenCount();
+                if (depth == 0) {
+                    span.matched = 0;
+                } else {
+                    span.matched = std::min(span.matched, depth - 1);
+                    if (span.matched == depth - 1 && depth <= tokens && token_matches(span.pointer.GetTokens()[depth - 1], index)) {
+                        span.matched = depth;
+                    }
+                }
+                if (span.matched == depth && depth == tokens) {
+                    span.capturing = true;
+                    span.begin = mark;
+                }
+            }
+        }
+
+        bool end_value() {
+            const size_t depth = frames.size();
+            for (PointerSpan& span : spans) {
+                if (span.capturing && span.pointer.GetTokenCount() == depth) {
+                    span.capturing = false;
+                    span.found = true;
+                    span.end = stream.Tell();
+                    resolve(span);
+                }
+            }
+            mark = stream.Tell();
+            return resolved < spans.size();
+        }
+
+        bool token_matches(const Pointer::Token& token, rapidjson::SizeType index) const {
+            const Frame& frame = frames.back();
+            if (frame.isArray) return token.index == index;
+            return token.length == frame.key.size() && std::memcmp(token.name, frame.key.data(), token.length) == 0;
+        }
+
+        void resolve(PointerSpan& span) {
+            if (span.done) return;
+            span.done = true;
+            ++resolved;
+        }
+
+        const Cursor& stream;
+        std::vector<PointerSpan>& spans;
+        std::vector<Frame> frames;
+        size_t mark = 0;
+        size_t resolved = 0;
+    };
+
+    // 文本在所有路径有结果之前就不合法时返回 false
+    static bool scan_pointers(const char* json, std::vector<PointerSpan>& spans) {
+        Cursor stream{json, json};
+        PointerScanner scanner(stream, spans);
+        Reader reader;
+        rapidjson::ParseResult result = reader.Parse<rapidjson::kParseNumbersAsStringsFlag>(stream, scanner);
+        if (result.IsError() && result.Code() != rapidjson::kParseErrorTermination) {
+            std::cerr << "JSON Parse Error" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // 解析 json 中 [begin, end) 的单个值并解码到 out；开头的空白以及 SAX 扫描
+    // 带进区间的 ',' ':' 被跳过
+    template <typename M>
+    static void decode_range(const char* json, size_t begin, size_t end, M& out) {
+        while (begin < end && (json[begin] == ',' || json[begin] == ':' || json[begin] == ' ' ||
+                               json[begin] == '\t' || json[begin] == '\r' || json[begin] == '\n')) {
+            ++begin;
+        }
+        Document doc;
+        doc.Parse(json + begin, end - begin);
+        O_SERIALIZE_STATS_JSON_POOL(doc.GetAllocator().Size());
+        if (!doc.HasParseError()) from_json(doc, out);
+    }
+
+    // 不小于该长度的 std::string / QByteArray 成员在 DOM 中只引用原始存储，不复制进
+    // 内存池。DOM 只在单次 obj_to_* 调用内存在，此时 obj 一定还有效
+    static constexpr size_t kReferenceSize = 4096;
+
+    static Value string_value(const char* str, size_t length, Allocator& allocator) {
+        if (length >= kReferenceSize) return Value(rapidjson::StringRef(str, length));
+        return Value(str, static_cast<rapidjson::SizeType>(length), allocator);
+    }
+
+    // to_json 对大字符串只做引用（见 string_value）；复制进 allocator，使 val 不再依赖 obj
+    static void own_strings(Value& val, Allocator& allocator) {
+        if (val.IsString()) {
+            if (val.GetStringLength() >= kReferenceSize) val.SetString(val.GetString(), val.GetStringLength(), allocator);
+        } else if (val.IsArray()) {
+            for (auto& item : val.GetArray()) own_strings(item, allocator);
+        } else if (val.IsObject()) {
+            for (auto it = val.MemberBegin(); it != val.MemberEnd(); ++it) own_strings(it->value, allocator);
+        }
+    }
+
+#ifdef O_SERIALIZE_USE_QT
+    static Value qjson_to_value(const QJsonValue& json, Allocator& allocator) {
+        switch (json.type()) {
+            case QJsonValue::Bool: return Value(json.toBool());
+            case QJsonValue::Double: {
+                // Qt 5 的 QJsonValue 只存 double；整数值转回整数，int 等成员的
+                // from_json 才能识别（2^53 以内的整数可由 double 精确表示）
+                const double d = json.toDouble();
+                if (std::trunc(d) == d && std::fabs(d) <= 9007199254740992.0 && !(d == 0 && std::signbit(d))) {
+                    return Value(static_cast<int64_t>(d));
+                }
+                return Value(d);
+            }
+            case QJsonValue::String: {
+                const QByteArray utf8 = json.toString().toUtf8();
+                return Value(utf8.constData(), static_cast<rapidjson::SizeType>(utf8.size()), allocator);
+            }
+            case QJsonValue::Array: {
+                const QJsonArray array = json.toArray();
+                Value arr(rapidjson::kArrayType);
+                arr.Reserve(static_cast<rapidjson::SizeType>(array.size()), allocator);
+                for (const QJsonValue& item : array) arr.PushBack(qjson_to_value(item, allocator), allocator);
+                return arr;
+            }
+            case QJsonValue::Object: {
+                const QJsonObject object = json.toObject();
+                Value obj(rapidjson::kObjectType);
+                for (auto it = object.begin(); it != object.end(); ++it) {
+                    const QByteArray key = it.key().toUtf8();
+                    obj.AddMember(Value(key.constData(), static_cast<rapidjson::SizeType>(key.size()), allocator),
+                                  qjson_to_value(it.value(), allocator), allocator);
+                }
+                return obj;
+            }
+            default: return Value(rapidjson::kNullType);
+        }
+    }
+
+    // Qt 5 的 QJsonValue 只存 double：绝对值超过 2^53 的整数会被舍入；大于
+    // INT64_MAX 的 uint64 不是 Int64，在任何 Qt 版本中都按 double 转换，同样丢失精度
+    static QJsonValue value_to_qjson(const Value& val) {
+        switch (val.GetType()) {
+            case rapidjson::kFalseType: return QJsonValue(false);
+            case rapidjson::kTrueType: return QJsonValue(true);
+            case rapidjson::kNumberType:
+                if (val.IsInt64()) return QJsonValue(static_cast<qint64>(val.GetInt64()));
+                return QJsonValue(val.GetDouble());
+            case rapidjson::kStringType: return QJsonValue(QString::fromUtf8(val.GetString(), static_cast<int>(val.GetStringLength())));
+            case rapidjson::kArrayType: {
+                QJsonArray array;
+                for (const auto& item : val.GetArray()) array.append(value_to_qjson(item));
+                return array;
+            }
+            case rapidjson::kObjectType: {
+                QJsonObject object;
+                for (auto it = val.MemberBegin(); it != val.MemberEnd(); ++it) {
+                    object.insert(QString::fromUtf8(it->name.GetString(), static_cast<int>(it->name.GetStringLength())), value_to_qjson(it->value));
+                }
+                return object;
+            }
+            default: return QJsonValue(QJsonValue::Null);
+        }
+    }
+#endif
+
+    // 写出 JSON 字符串时是否需要转义
+    static bool needs_escape(const char* str, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            const unsigned char c = static_cast<unsigned char>(str[i]);
+            if (c < 0x20 || c == '"' || c == '\\') return true;
+        }
+        return false;
+    }
+
+    // 写出器默认就是 rapidjson 的 Writer / PrettyWriter
+    template <typename Stream, typename Writer>
+    struct SinkWriter { typedef Writer type; };
+
+#if defined(__unix__) || defined(__APPLE__)
+    // 写进 IovecSink 时，引用原始存储且不需转义的大字符串不再复制进分块缓冲区，
+    // 而是作为指向成员本身的 iovec 段追加，由 writev / sendmsg 直接从成员发送。
+    // 复制进内存池的字符串（copy 为 true）随 DOM 一起释放，不能引用
+    template <typename Base>
+    class ScatterWriter : public Base {
+    public:
+        explicit ScatterWriter(IovecSink& sink) : Base(sink), _sink(sink) {}
+
+        bool String(const char* str, rapidjson::SizeType length, bool copy = false) {
+            if (copy || length < kReferenceSize || needs_escape(str, length)) return Base::String(str, length, copy);
+            // 长度为 0 的 RawValue 只输出逗号、冒号与缩进
+            Base::RawValue(str, 0, rapidjson::kStringType);
+            _sink.Put('"');
+            _sink.append_external(str, length);
+            _sink.Put('"');
+            return true;
+        }
+
+    private:
+        IovecSink& _sink;
+    };
+
+    template <typename Writer>
+    struct SinkWriter<IovecSink, Writer> { typedef ScatterWriter<Writer> type; };
+#endif
+
+    // 按 options 选择 Writer / PrettyWriter 并写出 val；键排序时会原地重排 val 的成员
+    template <typename Stream>
+    static void write_value(Value& val, Stream& stream, const WriteOptions& options) {
+        if (options.is_sorted()) sort_keys(val);
+        if (options.is_compact()) {
+            typename SinkWriter<Stream, rapidjson::Writer<Stream, rapidjson::UTF8<>, rapidjson::UTF8<>, BaseAllocator>>::type writer(stream);
+            if (options.maxDecimalPlaces >= 0) writer.SetMaxDecimalPlaces(options.maxDecimalPlaces);
+            val.Accept(writer);
+        } else {
+            typename SinkWriter<Stream, rapidjson::PrettyWriter<Stream, rapidjson::UTF8<>, rapidjson::UTF8<>, BaseAllocator>>::type writer(stream);
+            writer.SetIndent(options.indentChar, options.indentCount);
+            if (options.maxDecimalPlaces >= 0) writer.SetMaxDecimalPlaces(options.maxDecimalPlaces);
+            val.Accept(writer);
+        }
+    }
+
+    // --- 紧凑输出长度（size_hint） ---
+
+    // 与 rapidjson Writer::WriteDouble 相同的格式化；NaN / Inf 会被 Writer 拒绝，不输出
+    static size_t double_size(double val) {
+        if (!std::isfinite(val)) return 0;
+        char buf[25];
+        return static_cast<size_t>(rapidjson::internal::dtoa(val, buf) - buf);
+    }
+
+    template <typename I>
+    static size_t digit_count(I val) {
+        using U = typename std::make_unsigned<I>::type;
+        size_t size = 1;
+        U magnitude = static_cast<U>(val);
+        if constexpr (std::is_signed<I>::value) {
+            if (val < 0) {
+                magnitude = static_cast<U>(U(0) - magnitude);
+                ++size;
+            }
+        }
+        while (magnitude >= 10) {
+            magnitude /= 10;
+            ++size;
+        }
+        return size;
+    }
+
+    // 加上引号与转义后的长度：'"'、'\' 与 \b \f \n \r \t 占 2 个字符，
+    // 其余控制字符写为 \u00XX 占 6 个，非 ASCII 字节原样输出
+    static size_t quoted_size(const char* s, size_t length) {
+        size_t size = length + 2;
+        for (size_t i = 0; i < length; ++i) {
+            const unsigned char c = static_cast<unsigned char>(s[i]);
+            if (c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t') size += 1;
+            else if (c < 0x20) size += 5;
+        }
+        return size;
+    }
+
+    // 紧凑输出 val 的字节数
+    static size_t value_size(const Value& val) {
+        switch (val.GetType()) {
+            case rapidjson::kNullType: return 4;
+            case rapidjson::kFalseType: return 5;
+            case rapidjson::kTrueType: return 4;
+            case rapidjson::kStringType: return quoted_size(val.GetString(), val.GetStringLength());
+            case rapidjson::kNumberType:
+                if (val.IsInt64()) return digit_count(val.GetInt64());
+                if (val.IsUint64()) return digit_count(val.GetUint64());
+                return double_size(val.GetDouble());
+            case rapidjson::kArrayType: {
+                size_t size = 2 + (val.Empty() ? 0 : val.Size() - 1);
+                for (const auto& item : val.GetArray()) size += value_size(item);
+                return size;
+            }
+            case rapidjson::kObjectType: {
+                size_t size = 2 + (val.ObjectEmpty() ? 0 : val.MemberCount() - 1);
+                for (auto it = val.MemberBegin(); it != val.MemberEnd(); ++it) {
+                    size += quoted_size(it->name.GetString(), it->name.GetStringLength()) + 1 + value_size(it->value);
+                }
+                return size;
+            }
+        }
+        return 0;
+    }
+
+    static void sort_keys(Value& val) {
+        if (val.IsObject()) {
+            std::sort(val.MemberBegin(), val.MemberEnd(), [](const Value::Member& a, const Value::Member& b) {
+                return std::strcmp(a.name.GetString(), b.name.GetString()) < 0;
+            });
+            for (auto it = val.MemberBegin(); it != val.MemberEnd(); ++it) sort_keys(it->value);
+        } else if (val.IsArray()) {
+            for (auto& item : val.GetArray()) sort_keys(item);
+        }
+    }
+
     // --- 容器插入辅助函数 ---
     template <typename C, typename V>
     static auto add_item(C& c, const V& v) -> decltype(c.push_back(v)) { return c.push_back(v); }
@@ -108,59 +996,60 @@ private:
 
     // 反射类型的转发声明
     template <typename T>
-    static typename std::enable_if<Meta::has_reflection<T>::value, rapidjson::Value>::type
-    to_json(const T& obj, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value json(rapidjson::kObjectType);
+    static typename std::enable_if<Meta::has_reflection<T>::value, Value>::type
+    to_json(const T& obj, Allocator& allocator) {
+        Value json(rapidjson::kObjectType);
         Meta::visit_members(obj, [&](const char* name, const auto& member) {
-            rapidjson::Value key(name, allocator);
+            Value key(name, allocator);
             json.AddMember(key, to_json(member, allocator), allocator);
         });
         return json;
     }
 
     // 基本类型
-    static rapidjson::Value to_json(short val, rapidjson::Document::AllocatorType&) { return rapidjson::Value((int)val); }
-    static rapidjson::Value to_json(unsigned short val, rapidjson::Document::AllocatorType&) { return rapidjson::Value((unsigned int)val); }
-    static rapidjson::Value to_json(int val, rapidjson::Document::AllocatorType&) { return rapidjson::Value(val); }
-    static rapidjson::Value to_json(unsigned int val, rapidjson::Document::AllocatorType&) { return rapidjson::Value(val); }
-    static rapidjson::Value to_json(long val, rapidjson::Document::AllocatorType&) { return rapidjson::Value((int64_t)val); } 
-    static rapidjson::Value to_json(unsigned long val, rapidjson::Document::AllocatorType&) { return rapidjson::Value((uint64_t)val); }
-    static rapidjson::Value to_json(long long val, rapidjson::Document::AllocatorType&) { return rapidjson::Value(val); }
-    static rapidjson::Value to_json(unsigned long long val, rapidjson::Document::AllocatorType&) { return rapidjson::Value(val); }
-    static rapidjson::Value to_json(double val, rapidjson::Document::AllocatorType&) { return rapidjson::Value(val); }
-    static rapidjson::Value to_json(float val, rapidjson::Document::AllocatorType&) { return rapidjson::Value(val); }
-    static rapidjson::Value to_json(bool val, rapidjson::Document::AllocatorType&) { return rapidjson::Value(val); }
+    static Value to_json(short val, Allocator&) { return Value((int)val); }
+    static Value to_json(unsigned short val, Allocator&) { return Value((unsigned int)val); }
+    static Value to_json(int val, Allocator&) { return Value(val); }
+    static Value to_json(unsigned int val, Allocator&) { return Value(val); }
+    static Value to_json(long val, Allocator&) { return Value((int64_t)val); } 
+    static Value to_json(unsigned long val, Allocator&) { return Value((uint64_t)val); }
+    static Value to_json(long long val, Allocator&) { return Value(val); }
+    static Value to_json(unsigned long long val, Allocator&) { return Value(val); }
+    static Value to_json(double val, Allocator&) { return Value(val); }
+    // float 经最短表示转为 double，避免 1.1f 输出为 1.100000023841858
+    static Value to_json(float val, Allocator&) { return Value(Number::widen(val)); }
+    static Value to_json(bool val, Allocator&) { return Value(val); }
     
     // 8位整数类型
-    static rapidjson::Value to_json(signed char val, rapidjson::Document::AllocatorType&) { return rapidjson::Value((int)val); }
-    static rapidjson::Value to_json(unsigned char val, rapidjson::Document::AllocatorType&) { return rapidjson::Value((unsigned int)val); }
+    static Value to_json(signed char val, Allocator&) { return Value((int)val); }
+    static Value to_json(unsigned char val, Allocator&) { return Value((unsigned int)val); }
     
     // 枚举类型
     template <typename T>
-    static typename std::enable_if<std::is_enum<T>::value, rapidjson::Value>::type
-    to_json(T val, rapidjson::Document::AllocatorType&) {
-        return rapidjson::Value((int)val);
+    static typename std::enable_if<std::is_enum<T>::value, Value>::type
+    to_json(T val, Allocator&) {
+        return Value((int)val);
     }
     
-    static rapidjson::Value to_json(const std::string& val, rapidjson::Document::AllocatorType& allocator) {
-        return rapidjson::Value(val.c_str(), allocator);
+    static Value to_json(const std::string& val, Allocator& allocator) {
+        return string_value(val.data(), val.size(), allocator);
     }
 
-    static rapidjson::Value to_json(const char* val, rapidjson::Document::AllocatorType& allocator) {
-        return rapidjson::Value(val, allocator);
+    static Value to_json(const char* val, Allocator& allocator) {
+        return Value(val, allocator);
     }
 
     // 智能指针 (std::shared_ptr, std::unique_ptr)
     template <typename T>
-    static typename std::enable_if<Traits::is_smart_ptr<T>::value, rapidjson::Value>::type
-    to_json(const T& ptr, rapidjson::Document::AllocatorType& allocator) {
-        if (!ptr) return rapidjson::Value(rapidjson::kNullType);
+    static typename std::enable_if<Traits::is_smart_ptr<T>::value, Value>::type
+    to_json(const T& ptr, Allocator& allocator) {
+        if (!ptr) return Value(rapidjson::kNullType);
         return to_json(*ptr, allocator);
     }
 
     // std::variant 类型
     template <typename... Args>
-    static rapidjson::Value to_json(const std::variant<Args...>& v, rapidjson::Document::AllocatorType& allocator) {
+    static Value to_json(const std::variant<Args...>& v, Allocator& allocator) {
         return std::visit([&](const auto& val) {
             return to_json(val, allocator);
         }, v);
@@ -168,18 +1057,18 @@ private:
 
     // std::pair 类型
     template <typename K, typename V>
-    static rapidjson::Value to_json(const std::pair<K, V>& pair, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
-        rapidjson::Value key1("first", allocator);
+    static Value to_json(const std::pair<K, V>& pair, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
+        Value key1("first", allocator);
         obj.AddMember(key1, to_json(pair.first, allocator), allocator);
-        rapidjson::Value key2("second", allocator);
+        Value key2("second", allocator);
         obj.AddMember(key2, to_json(pair.second, allocator), allocator);
         return obj;
     }
 
     // std::pair 类型
     template <typename K, typename V>
-    static void from_json(const rapidjson::Value& json, std::pair<K, V>& pair) {
+    static void from_json(const Value& json, std::pair<K, V>& pair) {
         if (!json.IsObject()) return;
         if (json.HasMember("first")) from_json(json["first"], pair.first);
         if (json.HasMember("second")) from_json(json["second"], pair.second);
@@ -187,69 +1076,69 @@ private:
 
     // std::tuple 类型
     template <typename Tuple, size_t... Is>
-    static void tuple_to_json_helper(const Tuple& t, rapidjson::Value& arr, rapidjson::Document::AllocatorType& allocator, std::index_sequence<Is...>) {
+    static void tuple_to_json_helper(const Tuple& t, Value& arr, Allocator& allocator, std::index_sequence<Is...>) {
         (arr.PushBack(to_json(std::get<Is>(t), allocator), allocator), ...);
     }
 
     template <typename... Args>
-    static typename std::enable_if<Traits::is_tuple<std::tuple<Args...>>::value, rapidjson::Value>::type
-    to_json(const std::tuple<Args...>& t, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value arr(rapidjson::kArrayType);
+    static typename std::enable_if<Traits::is_tuple<std::tuple<Args...>>::value, Value>::type
+    to_json(const std::tuple<Args...>& t, Allocator& allocator) {
+        Value arr(rapidjson::kArrayType);
         tuple_to_json_helper(t, arr, allocator, std::index_sequence_for<Args...>{});
         return arr;
     }
 
 #ifdef O_SERIALIZE_USE_QT
-    static rapidjson::Value to_json(const QString& val, rapidjson::Document::AllocatorType& allocator) {
-        return rapidjson::Value(val.toStdString().c_str(), allocator);
+    static Value to_json(const QString& val, Allocator& allocator) {
+        return Value(val.toStdString().c_str(), allocator);
     }
 
     // Qt 日期/时间
-    static rapidjson::Value to_json(const QDate& val, rapidjson::Document::AllocatorType& allocator) {
-        return rapidjson::Value(val.toString(Qt::ISODate).toStdString().c_str(), allocator);
+    static Value to_json(const QDate& val, Allocator& allocator) {
+        return Value(val.toString(Qt::ISODate).toStdString().c_str(), allocator);
     }
-    static rapidjson::Value to_json(const QTime& val, rapidjson::Document::AllocatorType& allocator) {
-        return rapidjson::Value(val.toString(Qt::ISODate).toStdString().c_str(), allocator);
+    static Value to_json(const QTime& val, Allocator& allocator) {
+        return Value(val.toString(Qt::ISODate).toStdString().c_str(), allocator);
     }
-    static rapidjson::Value to_json(const QDateTime& val, rapidjson::Document::AllocatorType& allocator) {
-        return rapidjson::Value(val.toString(Qt::ISODate).toStdString().c_str(), allocator);
+    static Value to_json(const QDateTime& val, Allocator& allocator) {
+        return Value(val.toString(Qt::ISODate).toStdString().c_str(), allocator);
     }
 
     // Qt 几何图形
-    static rapidjson::Value to_json(const QPoint& val, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
+    static Value to_json(const QPoint& val, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
         obj.AddMember("x", val.x(), allocator);
         obj.AddMember("y", val.y(), allocator);
         return obj;
     }
-    static rapidjson::Value to_json(const QPointF& val, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
+    static Value to_json(const QPointF& val, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
         obj.AddMember("x", val.x(), allocator);
         obj.AddMember("y", val.y(), allocator);
         return obj;
     }
-    static rapidjson::Value to_json(const QSize& val, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
+    static Value to_json(const QSize& val, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
         obj.AddMember("width", val.width(), allocator);
         obj.AddMember("height", val.height(), allocator);
         return obj;
     }
-    static rapidjson::Value to_json(const QSizeF& val, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
+    static Value to_json(const QSizeF& val, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
         obj.AddMember("width", val.width(), allocator);
         obj.AddMember("height", val.height(), allocator);
         return obj;
     }
-    static rapidjson::Value to_json(const QRect& val, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
+    static Value to_json(const QRect& val, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
         obj.AddMember("x", val.x(), allocator);
         obj.AddMember("y", val.y(), allocator);
         obj.AddMember("width", val.width(), allocator);
         obj.AddMember("height", val.height(), allocator);
         return obj;
     }
-    static rapidjson::Value to_json(const QRectF& val, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
+    static Value to_json(const QRectF& val, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
         obj.AddMember("x", val.x(), allocator);
         obj.AddMember("y", val.y(), allocator);
         obj.AddMember("width", val.width(), allocator);
@@ -257,16 +1146,16 @@ private:
         return obj;
     }
     
-    static rapidjson::Value to_json(const QColor& val, rapidjson::Document::AllocatorType& allocator) {
-        return rapidjson::Value(val.name().toStdString().c_str(), allocator);
+    static Value to_json(const QColor& val, Allocator& allocator) {
+        return Value(val.name().toStdString().c_str(), allocator);
     }
     
-    static rapidjson::Value to_json(const QByteArray& val, rapidjson::Document::AllocatorType& allocator) {
+    static Value to_json(const QByteArray& val, Allocator& allocator) {
         // 简单的字符串表示，理想情况下应该是 Base64
-        return rapidjson::Value(val.toStdString().c_str(), allocator);
+        return string_value(val.constData(), static_cast<size_t>(val.size()), allocator);
     }
 
-    static rapidjson::Value to_json(const QVariant& val, rapidjson::Document::AllocatorType& allocator) {
+    static Value to_json(const QVariant& val, Allocator& allocator) {
         switch(val.type()) {
             case QVariant::Int: return to_json(val.toInt(), allocator);
             case QVariant::UInt: return to_json(val.toUInt(), allocator);
@@ -282,22 +1171,22 @@ private:
             default: 
                 // 如果可能，尝试转换为字符串
                 if (val.canConvert<QString>()) return to_json(val.toString(), allocator);
-                return rapidjson::Value(rapidjson::kNullType);
+                return Value(rapidjson::kNullType);
         }
     }
 
     // Qt 智能指针
     template <typename T>
-    static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value, rapidjson::Value>::type
-    to_json(const T& ptr, rapidjson::Document::AllocatorType& allocator) {
-        if (ptr.isNull()) return rapidjson::Value(rapidjson::kNullType);
+    static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value, Value>::type
+    to_json(const T& ptr, Allocator& allocator) {
+        if (ptr.isNull()) return Value(rapidjson::kNullType);
         return to_json(*ptr, allocator);
     }
 
     // Qt 智能指针 from_json 实现
     template <typename T>
     static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value>::type
-    from_json(const rapidjson::Value& json, T& ptr) {
+    from_json(const Value& json, T& ptr) {
         if (json.IsNull()) {
             ptr.reset(); // QSharedPointer/QScopedPointer 支持 reset()
             return;
@@ -307,19 +1196,19 @@ private:
     
     // 创建 Qt 智能指针的辅助函数
     template <typename T>
-    static auto create_qt_smart_ptr(QSharedPointer<T>& ptr, const rapidjson::Value& json) -> void {
+    static auto create_qt_smart_ptr(QSharedPointer<T>& ptr, const Value& json) -> void {
         ptr = QSharedPointer<T>::create();
         from_json(json, *ptr);
     }
     
     template <typename T>
-    static auto create_qt_smart_ptr(QScopedPointer<T>& ptr, const rapidjson::Value& json) -> void {
+    static auto create_qt_smart_ptr(QScopedPointer<T>& ptr, const Value& json) -> void {
         ptr.reset(new T());
         from_json(json, *ptr);
     }
     
     template <typename T>
-    static auto create_qt_smart_ptr(QPointer<T>& ptr, const rapidjson::Value&) -> void {
+    static auto create_qt_smart_ptr(QPointer<T>& ptr, const Value&) -> void {
         // 警告：QPointer 反序列化未完全支持（所有权问题）。
         ptr = nullptr;
     }
@@ -327,9 +1216,9 @@ private:
 
 #endif // (Vector, List, Set, Queue, Stack) 容器
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, rapidjson::Value>::type
-    to_json(const T& container, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value arr(rapidjson::kArrayType);
+    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, Value>::type
+    to_json(const T& container, Allocator& allocator) {
+        Value arr(rapidjson::kArrayType);
         for (const auto& item : container) {
             arr.PushBack(to_json(item, allocator), allocator);
         }
@@ -338,9 +1227,9 @@ private:
 
     // STL/Qt 映射 (Map, Hash)
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value, rapidjson::Value>::type
-    to_json(const T& map, rapidjson::Document::AllocatorType& allocator) {
-        rapidjson::Value obj(rapidjson::kObjectType);
+    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value, Value>::type
+    to_json(const T& map, Allocator& allocator) {
+        Value obj(rapidjson::kObjectType);
         
         // 针对不同映射类型的通用迭代
         if constexpr (Traits::is_stl_map<T>::value) {
@@ -357,13 +1246,13 @@ private:
 
             for (const auto& pair : map) {
                 if constexpr (is_std_string) {
-                    rapidjson::Value key(pair.first.c_str(), allocator);
+                    Value key(pair.first.c_str(), allocator);
                     obj.AddMember(key, to_json(pair.second, allocator), allocator);
                 }
                 #ifdef O_SERIALIZE_USE_QT
                 else if constexpr (is_qstring) {
                     std::string keyStr = pair.first.toStdString();
-                    rapidjson::Value key(keyStr.c_str(), allocator);
+                    Value key(keyStr.c_str(), allocator);
                     obj.AddMember(key, to_json(pair.second, allocator), allocator);
                 }
                 #endif
@@ -373,7 +1262,7 @@ private:
         else if constexpr (Traits::is_qt_map<T>::value) {
              auto it = map.begin();
              while (it != map.end()) {
-                 rapidjson::Value keyVal;
+                 Value keyVal;
                  // 处理 QString 键转换
                  // 假设键是 QString 或可转换为 string
                  std::string keyStr = val_to_string_helper(it.key());
@@ -404,7 +1293,7 @@ private:
     // 反射类型
     template <typename T>
     static typename std::enable_if<Meta::has_reflection<T>::value>::type
-    from_json(const rapidjson::Value& json, T& obj) {
+    from_json(const Value& json, T& obj) {
         if (!json.IsObject()) return;
         Meta::visit_members(obj, [&](const char* name, auto& member) {
             if (json.HasMember(name)) {
@@ -414,34 +1303,34 @@ private:
     }
 
     // 基本类型
-    static void from_json(const rapidjson::Value& json, short& val) { if(json.IsInt()) val = (short)json.GetInt(); }
-    static void from_json(const rapidjson::Value& json, unsigned short& val) { if(json.IsUint()) val = (unsigned short)json.GetUint(); }
-    static void from_json(const rapidjson::Value& json, int& val) { if(json.IsInt()) val = json.GetInt(); }
-    static void from_json(const rapidjson::Value& json, unsigned int& val) { if(json.IsUint()) val = json.GetUint(); }
-    static void from_json(const rapidjson::Value& json, long& val) { if(json.IsInt64()) val = (long)json.GetInt64(); }
-    static void from_json(const rapidjson::Value& json, unsigned long& val) { if(json.IsUint64()) val = (unsigned long)json.GetUint64(); }
-    static void from_json(const rapidjson::Value& json, long long& val) { if(json.IsInt64()) val = json.GetInt64(); }
-    static void from_json(const rapidjson::Value& json, unsigned long long& val) { if(json.IsUint64()) val = json.GetUint64(); }
-    static void from_json(const rapidjson::Value& json, double& val) { if(json.IsNumber()) val = json.GetDouble(); }
-    static void from_json(const rapidjson::Value& json, float& val) { if(json.IsNumber()) val = json.GetFloat(); }
-    static void from_json(const rapidjson::Value& json, bool& val) { if(json.IsBool()) val = json.GetBool(); }
+    static void from_json(const Value& json, short& val) { if(json.IsInt()) val = (short)json.GetInt(); }
+    static void from_json(const Value& json, unsigned short& val) { if(json.IsUint()) val = (unsigned short)json.GetUint(); }
+    static void from_json(const Value& json, int& val) { if(json.IsInt()) val = json.GetInt(); }
+    static void from_json(const Value& json, unsigned int& val) { if(json.IsUint()) val = json.GetUint(); }
+    static void from_json(const Value& json, long& val) { if(json.IsInt64()) val = (long)json.GetInt64(); }
+    static void from_json(const Value& json, unsigned long& val) { if(json.IsUint64()) val = (unsigned long)json.GetUint64(); }
+    static void from_json(const Value& json, long long& val) { if(json.IsInt64()) val = json.GetInt64(); }
+    static void from_json(const Value& json, unsigned long long& val) { if(json.IsUint64()) val = json.GetUint64(); }
+    static void from_json(const Value& json, double& val) { if(json.IsNumber()) val = json.GetDouble(); }
+    static void from_json(const Value& json, float& val) { if(json.IsNumber()) val = json.GetFloat(); }
+    static void from_json(const Value& json, bool& val) { if(json.IsBool()) val = json.GetBool(); }
     
-    static void from_json(const rapidjson::Value& json, signed char& val) { if(json.IsInt()) val = (signed char)json.GetInt(); }
-    static void from_json(const rapidjson::Value& json, unsigned char& val) { if(json.IsUint()) val = (unsigned char)json.GetUint(); }
+    static void from_json(const Value& json, signed char& val) { if(json.IsInt()) val = (signed char)json.GetInt(); }
+    static void from_json(const Value& json, unsigned char& val) { if(json.IsUint()) val = (unsigned char)json.GetUint(); }
 
     template <typename T>
     static typename std::enable_if<std::is_enum<T>::value>::type
-    from_json(const rapidjson::Value& json, T& val) {
+    from_json(const Value& json, T& val) {
         if(json.IsInt()) val = static_cast<T>(json.GetInt());
     }
     
-    static void from_json(const rapidjson::Value& json, std::string& val) { 
-        if(json.IsString()) val = json.GetString(); 
+    static void from_json(const Value& json, std::string& val) { 
+        if(json.IsString()) val.assign(json.GetString(), json.GetStringLength());
     }
 
     // std::tuple 类型
     template <typename Tuple, size_t... Is>
-    static void tuple_from_json_helper(const rapidjson::Value& arr, Tuple& t, std::index_sequence<Is...>) {
+    static void tuple_from_json_helper(const Value& arr, Tuple& t, std::index_sequence<Is...>) {
         if (!arr.IsArray()) return;
         size_t size = arr.Size();
         ( (Is < size ? (from_json(arr[Is], std::get<Is>(t)), 0) : 0), ... );
@@ -449,14 +1338,14 @@ private:
 
     template <typename... Args>
     static typename std::enable_if<Traits::is_tuple<std::tuple<Args...>>::value>::type
-    from_json(const rapidjson::Value& json, std::tuple<Args...>& t) {
+    from_json(const Value& json, std::tuple<Args...>& t) {
         tuple_from_json_helper(json, t, std::index_sequence_for<Args...>{});
     }
 
     // 智能指针
     template <typename T>
     static typename std::enable_if<Traits::is_smart_ptr<T>::value>::type
-    from_json(const rapidjson::Value& json, T& ptr) {
+    from_json(const Value& json, T& ptr) {
         if (json.IsNull()) {
             ptr.reset();
             return;
@@ -476,45 +1365,45 @@ private:
     }
 
 #ifdef O_SERIALIZE_USE_QT
-    static void from_json(const rapidjson::Value& json, QString& val) {
+    static void from_json(const Value& json, QString& val) {
         if(json.IsString()) val = QString::fromUtf8(json.GetString());
     }
     
-    static void from_json(const rapidjson::Value& json, QDate& val) {
+    static void from_json(const Value& json, QDate& val) {
         if(json.IsString()) val = QDate::fromString(QString::fromUtf8(json.GetString()), Qt::ISODate);
     }
-    static void from_json(const rapidjson::Value& json, QTime& val) {
+    static void from_json(const Value& json, QTime& val) {
         if(json.IsString()) val = QTime::fromString(QString::fromUtf8(json.GetString()), Qt::ISODate);
     }
-    static void from_json(const rapidjson::Value& json, QDateTime& val) {
+    static void from_json(const Value& json, QDateTime& val) {
         if(json.IsString()) val = QDateTime::fromString(QString::fromUtf8(json.GetString()), Qt::ISODate);
     }
 
-    static void from_json(const rapidjson::Value& json, QPoint& val) {
+    static void from_json(const Value& json, QPoint& val) {
         if(json.IsObject()) {
             if(json.HasMember("x")) val.setX(json["x"].GetInt());
             if(json.HasMember("y")) val.setY(json["y"].GetInt());
         }
     }
-    static void from_json(const rapidjson::Value& json, QPointF& val) {
+    static void from_json(const Value& json, QPointF& val) {
         if(json.IsObject()) {
             if(json.HasMember("x")) val.setX(json["x"].GetDouble());
             if(json.HasMember("y")) val.setY(json["y"].GetDouble());
         }
     }
-    static void from_json(const rapidjson::Value& json, QSize& val) {
+    static void from_json(const Value& json, QSize& val) {
         if(json.IsObject()) {
             if(json.HasMember("width")) val.setWidth(json["width"].GetInt());
             if(json.HasMember("height")) val.setHeight(json["height"].GetInt());
         }
     }
-    static void from_json(const rapidjson::Value& json, QSizeF& val) {
+    static void from_json(const Value& json, QSizeF& val) {
         if(json.IsObject()) {
             if(json.HasMember("width")) val.setWidth(json["width"].GetDouble());
             if(json.HasMember("height")) val.setHeight(json["height"].GetDouble());
         }
     }
-    static void from_json(const rapidjson::Value& json, QRect& val) {
+    static void from_json(const Value& json, QRect& val) {
         if(json.IsObject()) {
             int x=0,y=0,w=0,h=0;
             if(json.HasMember("x")) x = json["x"].GetInt();
@@ -524,7 +1413,7 @@ private:
             val.setRect(x,y,w,h);
         }
     }
-    static void from_json(const rapidjson::Value& json, QRectF& val) {
+    static void from_json(const Value& json, QRectF& val) {
         if(json.IsObject()) {
             double x=0,y=0,w=0,h=0;
             if(json.HasMember("x")) x = json["x"].GetDouble();
@@ -535,18 +1424,18 @@ private:
         }
     }
     
-    static void from_json(const rapidjson::Value& json, QColor& val) {
+    static void from_json(const Value& json, QColor& val) {
         if(json.IsString()) val.setNamedColor(QString::fromUtf8(json.GetString()));
     }
     
-    static void from_json(const rapidjson::Value& json, QByteArray& val) {
-        if(json.IsString()) val = QByteArray(json.GetString());
+    static void from_json(const Value& json, QByteArray& val) {
+        if(json.IsString()) val = QByteArray(json.GetString(), static_cast<int>(json.GetStringLength()));
     }
 
     // Qt 智能指针
     // QSharedPointer 特化
     template <typename T>
-    static void from_json(const rapidjson::Value& json, QSharedPointer<T>& ptr) {
+    static void from_json(const Value& json, QSharedPointer<T>& ptr) {
         if (json.IsNull()) {
             ptr.reset(); 
             return;
@@ -557,7 +1446,7 @@ private:
 
     // QScopedPointer 特化
     template <typename T>
-    static void from_json(const rapidjson::Value& json, QScopedPointer<T>& ptr) {
+    static void from_json(const Value& json, QScopedPointer<T>& ptr) {
         if (json.IsNull()) {
             ptr.reset(); 
             return;
@@ -568,20 +1457,20 @@ private:
 
     // QPointer 特化（通常不支持完全反序列化）
     template <typename T>
-    static void from_json(const rapidjson::Value&, QPointer<T>& ptr) {
+    static void from_json(const Value&, QPointer<T>& ptr) {
         ptr = nullptr;
     }
 
     // QPair 类型
     template <typename T>
     static typename std::enable_if<Traits::is_qpair<T>::value>::type
-    from_json(const rapidjson::Value& json, T& pair) {
+    from_json(const Value& json, T& pair) {
         if (!json.IsObject()) return;
         if (json.HasMember("first")) from_json(json["first"], pair.first);
         if (json.HasMember("second")) from_json(json["second"], pair.second);
     }
 
-    static void from_json(const rapidjson::Value& json, QVariant& val) {
+    static void from_json(const Value& json, QVariant& val) {
         if (json.IsInt()) val = json.GetInt();
         else if (json.IsUint()) val = json.GetUint();
         else if (json.IsInt64()) val = (qlonglong)json.GetInt64();
@@ -606,7 +1495,7 @@ private:
     // STL/Qt 容器
     template <typename T>
     static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value>::type
-    from_json(const rapidjson::Value& json, T& container) {
+    from_json(const Value& json, T& container) {
         if (!json.IsArray()) return;
         container.clear();
         for (const auto& item : json.GetArray()) {
@@ -619,7 +1508,7 @@ private:
     // STL/Qt 映射
     template <typename T>
     static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value>::type
-    from_json(const rapidjson::Value& json, T& map) {
+    from_json(const Value& json, T& map) {
         if (!json.IsObject()) return;
         
         map.clear();
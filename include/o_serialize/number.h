@@ -0,0 +1,269 @@
+#ifndef O_SERIALIZE_NUMBER_H
+#define O_SERIALIZE_NUMBER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace OSerialize {
+
+// XML / INI 的数值格式化与解析。JSON 的数值由 rapidjson 读写（输出用它的 Grisu2，
+// 实测比经 to_chars 格式化再 RawValue 写出更快），这里只为它提供 float 的 widen
+namespace Number {
+
+    // 任意算术类型的文本表示都不会超过这个长度
+    constexpr std::size_t kBufferSize = 32;
+
+    // 浮点数最短往返表示：输出能被原类型精确读回的最短十进制串。
+    // float 与 double 分开处理，float 不会被提升为 double 后再按 17 位输出。
+    // 标准库支持浮点 to_chars 时（内部为 Ryu 类算法）直接使用，否则回退到
+    // printf 的可往返精度（不保证最短，但保证往返）。
+#if defined(__cpp_lib_to_chars)
+    inline char* format(char* first, char* last, float val) {
+        return std::to_chars(first, last, val).ptr;
+    }
+
+    inline char* format(char* first, char* last, double val) {
+        return std::to_chars(first, last, val).ptr;
+    }
+#else
+    inline char* format(char* first, char* last, float val) {
+        int n = std::snprintf(first, last - first, "%.9g", static_cast<double>(val));
+        return n < 0 ? first : first + n;
+    }
+
+    inline char* format(char* first, char* last, double val) {
+        int n = std::snprintf(first, last - first, "%.17g", val);
+        return n < 0 ? first : first + n;
+    }
+#endif
+
+    // rapidjson Writer 默认的小数位上限，即不限制
+    constexpr int kDefaultMaxDecimalPlaces = 324;
+
+    // 非负有限值的最短往返有效数字：写入 digits（不含小数点与末尾的 0），
+    // 返回位数，exponent 满足 val = 0.d1d2...dn × 10^exponent（rapidjson dtoa 的约定）
+    template <typename T>
+    int shortest_digits(T val, char* digits, int& exponent) {
+        char buf[kBufferSize];
+#if defined(__cpp_lib_to_chars)
+        char* end = std::to_chars(buf, buf + sizeof(buf), val, std::chars_format::scientific).ptr;
+#else
+        int n = std::snprintf(buf, sizeof(buf), "%.*e", std::numeric_limits<T>::max_digits10 - 1, static_cast<double>(val));
+        char* end = buf + (n < 0 ? 0 : n);
+#endif
+        int length = 0;
+        const char* p = buf;
+        for (; p != end && *p != 'e'; ++p) {
+            if (*p != '.') digits[length++] = *p;
+        }
+        while (length > 1 && digits[length - 1] == '0') --length;
+        int e10 = 0;
+        if (p != end && ++p != end && *p == '+') ++p;
+        std::from_chars(p, end, e10);
+        exponent = e10 + 1;
+        return length;
+    }
+
+    // rapidjson 的排版（dtoa.h 的 Prettify / WriteExponent）：在最短往返的有效数字上
+    // 选择定点或指数形式，整数值补 ".0"，超出 maxDecimalPlaces 的小数位截断并去掉
+    // 末尾的 0，小于 10^-maxDecimalPlaces 的值输出为 0.0。val 须为有限值，
+    // first 起至少有 kBufferSize 字节
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, char*>::type
+    prettify(char* first, T val, int maxDecimalPlaces = kDefaultMaxDecimalPlaces) {
+        if (std::signbit(val)) {
+            *first++ = '-';
+            val = -val;
+        }
+        char* buffer = first;
+        int kk = 0;
+        const int length = shortest_digits(val, buffer, kk);
+        const int k = kk - length;
+        if (0 <= k && kk <= 21) {
+            // 1234e7 -> 12340000000.0
+            for (int i = length; i < kk; i++) buffer[i] = '0';
+            buffer[kk] = '.';
+            buffer[kk + 1] = '0';
+            return &buffer[kk + 2];
+        }
+        if (0 < kk && kk <= 21) {
+            // 1234e-2 -> 12.34
+            std::memmove(&buffer[kk + 1], &buffer[kk], static_cast<std::size_t>(length - kk));
+            buffer[kk] = '.';
+            if (0 > k + maxDecimalPlaces) {
+                for (int i = kk + maxDecimalPlaces; i > kk + 1; i--) {
+                    if (buffer[i] != '0') return &buffer[i + 1];
+                }
+                return &buffer[kk + 2];
+            }
+            return &buffer[length + 1];
+        }
+        if (-6 < kk && kk <= 0) {
+            // 1234e-6 -> 0.001234
+            const int offset = 2 - kk;
+            std::memmove(&buffer[offset], &buffer[0], static_cast<std::size_t>(length));
+            buffer[0] = '0';
+            buffer[1] = '.';
+            for (int i = 2; i < offset; i++) buffer[i] = '0';
+            if (length - kk > maxDecimalPlaces) {
+                for (int i = maxDecimalPlaces + 1; i > 2; i--) {
+                    if (buffer[i] != '0') return &buffer[i + 1];
+                }
+                return &buffer[3];
+            }
+            return &buffer[length + offset];
+        }
+        if (kk < -maxDecimalPlaces) {
+            buffer[0] = '0';
+            buffer[1] = '.';
+            buffer[2] = '0';
+            return &buffer[3];
+        }
+        // 1234e30 -> 1.234e33
+        char* p = &buffer[1];
+        if (length > 1) {
+            std::memmove(&buffer[2], &buffer[1], static_cast<std::size_t>(length - 1));
+            buffer[1] = '.';
+            p = &buffer[length + 1];
+        }
+        *p++ = 'e';
+        return std::to_chars(p, p + 8, kk - 1).ptr;
+    }
+
+    // 限制小数位数的浮点格式化（WriteOptions::maxDecimalPlaces）：排版与截断规则与
+    // rapidjson 的 SetMaxDecimalPlaces 相同，如 1.23456789e-05 保留 6 位输出 0.000012。
+    // maxDecimalPlaces < 0 时不限制，输出最短往返表示
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, char*>::type
+    format(char* first, char* last, T val, int maxDecimalPlaces) {
+        if (maxDecimalPlaces < 0 || !std::isfinite(val)) return format(first, last, val);
+        return prettify(first, val, maxDecimalPlaces);
+    }
+
+    // 整数：to_chars，不经过 stringstream
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, char*>::type
+    format(char* first, char* last, T val) {
+        return std::to_chars(first, last, val).ptr;
+    }
+
+    // 枚举：按底层整数类型输出
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value, char*>::type
+    format(char* first, char* last, T val) {
+        return format(first, last, static_cast<typename std::underlying_type<T>::type>(val));
+    }
+
+    template <typename T>
+    std::string to_string(T val) {
+        char buf[kBufferSize];
+        return std::string(buf, format(buf, buf + sizeof(buf), val));
+    }
+
+    // 将 float 转为与其最短十进制表示最接近的 double。
+    // rapidjson 只存储 double，直接提升会让 1.1f 输出为 1.100000023841858；
+    // 经过最短表示中转后，double 的最短输出与 float 的最短输出一致。
+    // 代价是每个 float 多一次格式化与解析，写出时 rapidjson 还要再格式化一次
+    inline double widen(float val) {
+        char buf[kBufferSize + 1];
+        char* end = format(buf, buf + kBufferSize, val);
+#if defined(__cpp_lib_to_chars)
+        double out = static_cast<double>(val);
+        std::from_chars(buf, end, out);
+        return out;
+#else
+        *end = '\0';
+        return std::strtod(buf, nullptr);
+#endif
+    }
+
+    // --- 解析 ---
+    // 所有 parse 重载直接在 [first, last) 上工作：不构造临时 std::string，不抛异常。
+    // 失败（格式错误、溢出、有多余字符）时返回 false 且不修改 val。
+    // 首尾空白会被忽略，与 std::stoi 等函数的行为保持一致。
+
+    inline void trim(const char*& first, const char*& last) {
+        while (first != last && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n')) ++first;
+        while (last != first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r' || last[-1] == '\n')) --last;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type
+    parse(const char* first, const char* last, T& val) {
+        trim(first, last);
+        if (first != last && *first == '+') ++first;
+        if (first == last || *first == '+' || (*first == '-' && std::is_unsigned<T>::value)) return false;
+        T out = 0;
+        auto res = std::from_chars(first, last, out);
+        if (res.ec != std::errc() || res.ptr != last) return false;
+        val = out;
+        return true;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+    parse(const char* first, const char* last, T& val) {
+        trim(first, last);
+        if (first != last && *first == '+') ++first;
+        if (first == last || *first == '+') return false;
+        T out = 0;
+#if defined(__cpp_lib_to_chars)
+        auto res = std::from_chars(first, last, out);
+        if (res.ec != std::errc() || res.ptr != last) return false;
+#else
+        char buf[64];
+        std::size_t n = static_cast<std::size_t>(last - first);
+        if (n >= sizeof(buf)) return false;
+        std::memcpy(buf, first, n);
+        buf[n] = '\0';
+        char* end = nullptr;
+        out = static_cast<T>(std::strtod(buf, &end));
+        if (end != buf + n) return false;
+#endif
+        val = out;
+        return true;
+    }
+
+    // 布尔：接受 true/false 与 1/0
+    inline bool parse(const char* first, const char* last, bool& val) {
+        trim(first, last);
+        std::size_t n = static_cast<std::size_t>(last - first);
+        if ((n == 4 && std::memcmp(first, "true", 4) == 0) || (n == 1 && *first == '1')) {
+            val = true;
+            return true;
+        }
+        if ((n == 5 && std::memcmp(first, "false", 5) == 0) || (n == 1 && *first == '0')) {
+            val = false;
+            return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value, bool>::type
+    parse(const char* first, const char* last, T& val) {
+        typename std::underlying_type<T>::type raw;
+        if (!parse(first, last, raw)) return false;
+        val = static_cast<T>(raw);
+        return true;
+    }
+
+    template <typename T>
+    bool parse(const std::string& s, T& val) {
+        return parse(s.data(), s.data() + s.size(), val);
+    }
+
+} // namespace Number
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_NUMBER_H
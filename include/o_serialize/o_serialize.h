@@ -3,6 +3,7 @@
 
 #include <tuple>
 #include <functional>
+#include <cstring>
 #include <type_traits>
 
 namespace OSerialize {
@@ -33,6 +34,20 @@ namespace Meta {
         Reflector<T>::visit(obj, std::forward<Visitor>(visitor));
     }
 
+    // Applies visitor(name, &T::member) to all members, for walking two objects side by side
+    template <typename T, typename Visitor>
+    typename std::enable_if<has_reflection<T>::value>::type
+    visit_fields(Visitor&& visitor) {
+        Reflector<T>::visit_fields(std::forward<Visitor>(visitor));
+    }
+
+    // Per-member XML metadata: names of the members written as attributes
+    // (<point x="1" y="2"/>) instead of child elements. See O_SERIALIZE_XML_ATTRIBUTES.
+    template <typename T>
+    struct XmlAttributes {
+        static bool contains(const char*) { return false; }
+    };
+
 } // namespace Meta
 
 } // namespace OSerialize
@@ -73,12 +88,16 @@ namespace Meta {
 // The action will be: visitor(#member, obj.member);
 #define VISIT_MEMBER(member) visitor(#member, obj.member);
 
+// The action will be: visitor(#member, &Type::member);
+#define VISIT_FIELD(member) visitor(#member, &type::member);
+
 // Macro to register a struct
 #define O_SERIALIZE_STRUCT(Type, ...) \
 namespace OSerialize { namespace Meta { \
     template <> \
     struct Reflector<Type> { \
         static constexpr bool is_defined = true; \
+        using type = Type; \
         \
         template <typename Visitor> \
         static void visit(Type& obj, Visitor&& visitor) { \
@@ -89,6 +108,28 @@ namespace OSerialize { namespace Meta { \
         static void visit(const Type& obj, Visitor&& visitor) { \
             FOR_EACH(VISIT_MEMBER, __VA_ARGS__) \
         } \
+        \
+        template <typename Visitor> \
+        static void visit_fields(Visitor&& visitor) { \
+            FOR_EACH(VISIT_FIELD, __VA_ARGS__) \
+        } \
+    }; \
+}}
+
+#define STRINGIFY_MEMBER(member) #member,
+
+// Macro to mark scalar members of a registered struct as XML attributes
+#define O_SERIALIZE_XML_ATTRIBUTES(Type, ...) \
+namespace OSerialize { namespace Meta { \
+    template <> \
+    struct XmlAttributes<Type> { \
+        static bool contains(const char* name) { \
+            static const char* const names[] = { FOR_EACH(STRINGIFY_MEMBER, __VA_ARGS__) }; \
+            for (const char* n : names) { \
+                if (std::strcmp(n, name) == 0) return true; \
+            } \
+            return false; \
+        } \
     }; \
 }}
 
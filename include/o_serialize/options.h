@@ -0,0 +1,179 @@
+#ifndef O_SERIALIZE_OPTIONS_H
+#define O_SERIALIZE_OPTIONS_H
+
+#include "o_serialize/base.h"
+#include "o_serialize/o_serialize.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace OSerialize {
+
+// 写出接口共用的输出选项
+struct WriteOptions {
+    // 排版：Pretty 为缩进换行的可读格式，Compact 不输出任何多余空白。
+    // INI 没有缩进，Compact 只是省去节之间的空行
+    enum Layout { Pretty, Compact };
+
+    // 键顺序：Declaration 按 O_SERIALIZE_STRUCT 中的声明顺序与容器自身的迭代顺序，
+    // Sorted 把成员名和 map 的键按字典序排列，unordered_map / QHash 的输出因此稳定，
+    // 便于 diff 与做缓存键
+    enum KeyOrder { Declaration, Sorted };
+
+    Layout layout = Pretty;
+
+    // Pretty 排版每层缩进 indentCount 个 indentChar。
+    // JSON 只接受 ' '、'\t'、'\n'、'\r'（rapidjson PrettyWriter 的限制）
+    char indentChar = ' ';
+    unsigned indentCount = 4;
+
+    // 浮点数小数点后最多保留的位数，多出的位被截断（与 rapidjson 的
+    // SetMaxDecimalPlaces 一致）；负数表示不限制，输出最短往返表示
+    int maxDecimalPlaces = -1;
+
+    KeyOrder keyOrder = Declaration;
+
+    // XML：把反射结构体的所有标量成员写为属性（<point x="1" y="2"/>），
+    // 而不是子元素。单个成员可用 O_SERIALIZE_XML_ATTRIBUTES 标记
+    bool xmlAttributes = false;
+
+    // 写文件（JSON::obj_to_file）：以 O_DIRECT 打开，绕过页缓存，适合一次写出
+    // 不再读取的大文件；文件系统不支持时自动退回普通写入
+    bool directIO = false;
+
+    // 写文件前用 fallocate 预留的字节数（仅 Linux，0 表示不预留），
+    // 可减少大文件的碎片与元数据更新
+    size_t preallocate = 0;
+
+    bool is_compact() const { return layout == Compact; }
+    bool is_sorted() const { return keyOrder == Sorted; }
+
+    static WriteOptions pretty() { return WriteOptions(); }
+    static WriteOptions compact() {
+        WriteOptions options;
+        options.layout = Compact;
+        return options;
+    }
+};
+
+// 反序列化时只读取的顶层成员集合（JSON::string_to_obj、XML::parse 的重载），
+// 未选中的成员在解析层面直接跳过，保持默认值
+//
+//   FieldMask<Order> mask(&Order::id, &Order::customer);
+//   mask.add("tags");   // 也可以在运行时按名称选择
+template <typename T>
+class FieldMask {
+    static_assert(Meta::has_reflection<T>::value, "FieldMask requires a type registered with O_SERIALIZE_STRUCT");
+
+public:
+    FieldMask() = default;
+
+    template <typename... M>
+    explicit FieldMask(M T::*... fields) { (add(fields), ...); }
+
+    template <typename M>
+    FieldMask& add(M T::*field) {
+        size_t index = 0;
+        Meta::visit_fields<T>([&](const char*, auto candidate) {
+            if constexpr (std::is_same<decltype(candidate), M T::*>::value) {
+                if (candidate == field) _bits |= bit(index);
+            }
+            ++index;
+        });
+        return *this;
+    }
+
+    // 不是成员名时忽略
+    FieldMask& add(const char* name) {
+        size_t index = 0;
+        Meta::visit_fields<T>([&](const char* memberName, auto) {
+            if (std::strcmp(memberName, name) == 0) _bits |= bit(index);
+            ++index;
+        });
+        return *this;
+    }
+
+    // index 为成员在 O_SERIALIZE_STRUCT 中的声明序号
+    bool contains(size_t index) const { return (_bits & bit(index)) != 0; }
+
+    bool contains(const char* first, size_t length) const {
+        size_t index = 0;
+        bool found = false;
+        Meta::visit_fields<T>([&](const char* memberName, auto) {
+            if (!found && contains(index) && std::strlen(memberName) == length && std::memcmp(memberName, first, length) == 0) found = true;
+            ++index;
+        });
+        return found;
+    }
+
+    bool empty() const { return _bits == 0; }
+
+private:
+    // O_SERIALIZE_STRUCT 最多支持 25 个成员
+    static uint64_t bit(size_t index) { return index < 64 ? uint64_t(1) << index : 0; }
+
+    uint64_t _bits = 0;
+};
+
+// 按 options.keyOrder 的顺序遍历，供各后端的写出代码共用
+namespace Ordered {
+
+    // visitor(name, member)：Sorted 时按成员名排序。先收集成员名，再按序逐个
+    // 访问，每个成员多一次遍历；结构体成员数有限，开销可以忽略
+    template <typename T, typename Visitor>
+    void visit_members(const T& obj, const WriteOptions& options, Visitor&& visitor) {
+        if (!options.is_sorted()) {
+            Meta::visit_members(obj, visitor);
+            return;
+        }
+        std::vector<const char*> names;
+        Meta::visit_members(obj, [&](const char* name, const auto&) { names.push_back(name); });
+        std::sort(names.begin(), names.end(), [](const char* a, const char* b) { return std::strcmp(a, b) < 0; });
+        for (const char* wanted : names) {
+            Meta::visit_members(obj, [&](const char* name, const auto& member) {
+                if (std::strcmp(name, wanted) == 0) visitor(name, member);
+            });
+        }
+    }
+
+    // f(key, value)：Sorted 时按键排序；std::map / QMap 本身已有序，不再排序
+    template <typename T, typename F>
+    void for_each_entry(const T& map, const WriteOptions& options, F&& f) {
+        constexpr bool alreadySorted = std::is_same<T, std::map<typename T::key_type, typename T::mapped_type>>::value
+#ifdef O_SERIALIZE_USE_QT
+            || std::is_same<T, QMap<typename T::key_type, typename T::mapped_type>>::value
+#endif
+            ;
+        if constexpr (Traits::is_stl_map<T>::value) {
+            if (alreadySorted || !options.is_sorted()) {
+                for (const auto& pair : map) f(pair.first, pair.second);
+                return;
+            }
+            std::vector<typename T::const_iterator> entries;
+            entries.reserve(map.size());
+            for (auto it = map.begin(); it != map.end(); ++it) entries.push_back(it);
+            std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a->first < b->first; });
+            for (const auto& it : entries) f(it->first, it->second);
+        }
+#ifdef O_SERIALIZE_USE_QT
+        else {
+            if (alreadySorted || !options.is_sorted()) {
+                for (auto it = map.begin(); it != map.end(); ++it) f(it.key(), it.value());
+                return;
+            }
+            std::vector<typename T::const_iterator> entries;
+            entries.reserve(static_cast<size_t>(map.size()));
+            for (auto it = map.begin(); it != map.end(); ++it) entries.push_back(it);
+            std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.key() < b.key(); });
+            for (const auto& it : entries) f(it.key(), it.value());
+        }
+#endif
+    }
+
+} // namespace Ordered
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_OPTIONS_H
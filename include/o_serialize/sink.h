@@ -0,0 +1,246 @@
+#ifndef O_SERIALIZE_SINK_H
+#define O_SERIALIZE_SINK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace OSerialize {
+
+// rapidjson output streams that write into caller-owned storage, so a
+// serialized message does not have to be copied out of an intermediate
+// StringBuffer. The PutReserve/PutUnsafe overloads at the end of the file are
+// found by ADL. None of the sinks acts on PutReserve: rapidjson reserves the
+// worst case for every string (six bytes per character for \u escapes), and
+// honouring that would make room for far more than is ever written.
+
+// Writes into a std::string that is reused across messages: its contents are
+// replaced but its capacity is kept, so steady-state serialization does not
+// allocate. Call finish() (or let the sink go out of scope) to trim the string
+// to the bytes written.
+class StringSink {
+public:
+    typedef char Ch;
+
+    static constexpr size_t kInitialSize = 256;
+
+    static constexpr size_t kGrowStep = 4096;
+
+    explicit StringSink(std::string& out) : _out(out) {
+        _out.clear();
+        _out.resize(kInitialSize);
+        _cur = &_out[0];
+        _end = _cur + _out.size();
+    }
+
+    ~StringSink() { finish(); }
+
+    StringSink(const StringSink&) = delete;
+    StringSink& operator=(const StringSink&) = delete;
+
+    void Put(Ch c) {
+        if (_cur == _end) grow(1);
+        *_cur++ = c;
+    }
+
+    void Reserve(size_t) {}
+    void PutUnsafe(Ch c) { Put(c); }
+    void Flush() {}
+
+    void finish() {
+        if (_cur) _out.resize(size());
+        _cur = _end = nullptr;
+    }
+
+    size_t size() const { return static_cast<size_t>(_cur - _out.data()); }
+
+    // Not an input stream
+    Ch Peek() const { return 0; }
+    Ch Take() { return 0; }
+    size_t Tell() const { return size(); }
+    Ch* PutBegin() { return nullptr; }
+    size_t PutEnd(Ch*) { return 0; }
+
+private:
+    // The capacity doubles, but the size (which resize() zero-fills) only
+    // advances kGrowStep at a time, so pages past the output are never touched
+    // and the capacity stays within twice the longest message
+    void grow(size_t count) {
+        const size_t used = size();
+        const size_t need = used + std::max(count, kGrowStep);
+        if (need > _out.capacity()) _out.reserve(std::max(need, _out.capacity() * 2));
+        _out.resize(need);
+        _cur = &_out[0] + used;
+        _end = &_out[0] + _out.size();
+    }
+
+    std::string& _out;
+    char* _cur;
+    char* _end;
+};
+
+// Writes into a fixed buffer. Output that does not fit is dropped and counted:
+// overflowed() reports it and required() gives the size the buffer would have
+// needed, so the caller can retry with a larger one.
+class BufferSink {
+public:
+    typedef char Ch;
+
+    BufferSink(char* data, size_t size) : _begin(data), _cur(data), _end(data + size) {}
+
+    void Put(Ch c) {
+        if (_cur != _end) *_cur++ = c;
+        else ++_dropped;
+    }
+
+    void Reserve(size_t) {}
+    void PutUnsafe(Ch c) { Put(c); }
+    void Flush() {}
+
+    bool overflowed() const { return _dropped != 0; }
+    size_t size() const { return static_cast<size_t>(_cur - _begin); }
+    size_t required() const { return size() + _dropped; }
+
+    // Not an input stream
+    Ch Peek() const { return 0; }
+    Ch Take() { return 0; }
+    size_t Tell() const { return required(); }
+    Ch* PutBegin() { return nullptr; }
+    size_t PutEnd(Ch*) { return 0; }
+
+private:
+    char* _begin;
+    char* _cur;
+    char* _end;
+    size_t _dropped = 0;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Writes into a chain of fixed-size blocks and exposes them as an iovec gather
+// list for writev()/sendmsg(). Output never moves once written, so large
+// messages are not copied by buffer growth, and large payloads can be added by
+// reference with append_external(). reset() keeps the blocks for the next
+// message.
+class IovecSink {
+public:
+    typedef char Ch;
+
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    IovecSink() = default;
+    IovecSink(const IovecSink&) = delete;
+    IovecSink& operator=(const IovecSink&) = delete;
+
+    void Put(Ch c) {
+        if (_cur == _end) next_block();
+        *_cur++ = c;
+    }
+
+    // Tokens may straddle two blocks, so every byte stays bounds-checked
+    void Reserve(size_t) {}
+    void PutUnsafe(Ch c) { Put(c); }
+    void Flush() {}
+
+    // Starts a new message, reusing the blocks already allocated
+    void reset() {
+        _iov.clear();
+        _used = 0;
+        _blockStart = _cur = _end = nullptr;
+        _total = 0;
+    }
+
+    // Appends a segment that points at the caller's storage instead of copying
+    // it; the storage must stay valid until the gather list has been sent
+    void append_external(const void* data, size_t size) {
+        close_block();
+        _iov.push_back({const_cast<void*>(data), size});
+        _total += size;
+    }
+
+    // The gather list for what has been written so far
+    const std::vector<iovec>& iov() {
+        close_block();
+        return _iov;
+    }
+
+    size_t size() const { return _total + pending(); }
+
+    // Writes the whole list to fd, resuming after partial writes and splitting
+    // lists longer than IOV_MAX; false if a write failed
+    bool write_to(int fd) {
+        std::vector<iovec> list = iov();
+        size_t first = 0;
+        while (first < list.size()) {
+            const int count = static_cast<int>(std::min<size_t>(list.size() - first, IOV_MAX));
+            ssize_t n = ::writev(fd, &list[first], count);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            size_t done = static_cast<size_t>(n);
+            while (first < list.size() && done >= list[first].iov_len) done -= list[first++].iov_len;
+            if (done > 0) {
+                list[first].iov_base = static_cast<char*>(list[first].iov_base) + done;
+                list[first].iov_len -= done;
+            }
+        }
+        return true;
+    }
+
+    // Not an input stream
+    Ch Peek() const { return 0; }
+    Ch Take() { return 0; }
+    size_t Tell() const { return size(); }
+    Ch* PutBegin() { return nullptr; }
+    size_t PutEnd(Ch*) { return 0; }
+
+private:
+    size_t pending() const { return static_cast<size_t>(_cur - _blockStart); }
+
+    // Appends the bytes written into the current block since the last call
+    void close_block() {
+        if (_cur == _blockStart) return;
+        _iov.push_back({_blockStart, pending()});
+        _total += pending();
+        _blockStart = _cur;
+    }
+
+    void next_block() {
+        close_block();
+        if (_used == _blocks.size()) _blocks.emplace_back(new char[kBlockSize]);
+        _blockStart = _cur = _blocks[_used++].get();
+        _end = _cur + kBlockSize;
+    }
+
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    size_t _used = 0;
+    std::vector<iovec> _iov;
+    char* _blockStart = nullptr;
+    char* _cur = nullptr;
+    char* _end = nullptr;
+    size_t _total = 0;
+};
+
+#endif
+
+// Bulk-write hooks picked up by rapidjson's writers through ADL
+inline void PutReserve(StringSink& sink, size_t count) { sink.Reserve(count); }
+inline void PutUnsafe(StringSink& sink, char c) { sink.PutUnsafe(c); }
+inline void PutReserve(BufferSink& sink, size_t count) { sink.Reserve(count); }
+inline void PutUnsafe(BufferSink& sink, char c) { sink.PutUnsafe(c); }
+#if defined(__unix__) || defined(__APPLE__)
+inline void PutReserve(IovecSink& sink, size_t count) { sink.Reserve(count); }
+inline void PutUnsafe(IovecSink& sink, char c) { sink.PutUnsafe(c); }
+#endif
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_SINK_H
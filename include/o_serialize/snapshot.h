@@ -0,0 +1,221 @@
+#ifndef O_SERIALIZE_SNAPSHOT_H
+#define O_SERIALIZE_SNAPSHOT_H
+
+#include "o_serialize/json.h"
+#include "o_serialize/ini.h"
+#include "o_serialize/xml.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OSerialize {
+
+// Per-thread reader slots of one Snapshot. A slot holds the epoch its thread
+// entered a read section in, or 0 while the thread is not reading.
+class SnapshotRegistry {
+public:
+    struct Slot {
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<bool> used{true};
+        unsigned depth = 0; // nesting, only touched by the owning thread
+        Slot* next = nullptr;
+    };
+
+    ~SnapshotRegistry() {
+        Slot* slot = _head.load();
+        while (slot) {
+            Slot* next = slot->next;
+            delete slot;
+            slot = next;
+        }
+    }
+
+    // Slot of the calling thread, claimed on its first read. Slots are released
+    // when the thread exits and reused by later threads.
+    //
+    // The registry read last is checked first. Otherwise the thread's list is
+    // scanned, and entries whose Snapshot is gone are dropped on the way: the
+    // list then holds the only reference, and no other thread can take a new
+    // one, so dropping it deletes the registry and its slots. The list holds the
+    // live Snapshots the thread reads, plus any destroyed since it last switched.
+    static Slot& local(const std::shared_ptr<SnapshotRegistry>& registry) {
+        thread_local LocalSlots slots;
+        auto& entries = slots.entries;
+        if (!entries.empty() && entries.front().first == registry) return *entries.front().second;
+
+        Slot* slot = nullptr;
+        size_t kept = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].first == registry) slot = entries[i].second;
+            else if (entries[i].first.use_count() == 1) continue;
+            if (kept != i) entries[kept] = std::move(entries[i]);
+            ++kept;
+        }
+        entries.resize(kept);
+        if (!slot) {
+            slot = registry->acquire();
+            entries.emplace_back(registry, slot);
+        }
+        // Most recently read first
+        for (auto& entry : entries) {
+            if (entry.second == slot) {
+                std::swap(entry, entries.front());
+                break;
+            }
+        }
+        return *slot;
+    }
+
+    // Smallest epoch of a thread currently reading, or UINT64_MAX
+    uint64_t min_active_epoch() const {
+        uint64_t min = UINT64_MAX;
+        for (Slot* slot = _head.load(); slot; slot = slot->next) {
+            const uint64_t epoch = slot->epoch.load();
+            if (epoch != 0 && epoch < min) min = epoch;
+        }
+        return min;
+    }
+
+private:
+    // Holds the registries the thread has slots in, so they outlive the thread's use
+    struct LocalSlots {
+        std::vector<std::pair<std::shared_ptr<SnapshotRegistry>, Slot*>> entries;
+        ~LocalSlots() {
+            for (auto& entry : entries) entry.second->used.store(false);
+        }
+    };
+
+    Slot* acquire() {
+        for (Slot* slot = _head.load(); slot; slot = slot->next) {
+            bool expected = false;
+            if (slot->used.compare_exchange_strong(expected, true)) return slot;
+        }
+        Slot* slot = new Slot();
+        slot->next = _head.load();
+        while (!_head.compare_exchange_weak(slot->next, slot)) {}
+        return slot;
+    }
+
+    std::atomic<Slot*> _head{nullptr};
+};
+
+// Holds the current version of a deserialized object for concurrent readers.
+//
+// Readers take a Reader, which pins the version current at that moment. Reads
+// never take the writers' mutex and touch no reference counts. Reading the same
+// Snapshot as last time is a few atomic loads and stores. A thread's first read
+// of a Snapshot allocates or reuses a slot with a compare-and-swap loop, and
+// switching Snapshots scans the thread's short list of them (see
+// SnapshotRegistry::local), so those reads are not wait-free. A writer publishes
+// a new version with one atomic pointer swap. The old version is retired and
+// deleted once no thread is still in a read section that began before the swap
+// (epoch-based reclamation). Writers serialize on a mutex.
+//
+// All atomics use sequentially consistent ordering: a reader's epoch store must
+// be ordered before its pointer load as seen by the writer's epoch scan.
+template <typename T>
+class Snapshot {
+public:
+    using Loader = std::function<bool(const std::string& path, T& obj)>;
+
+    // RAII read section; the object stays valid until the Reader is destroyed
+    class Reader {
+    public:
+        explicit Reader(const Snapshot& snapshot)
+            : _slot(SnapshotRegistry::local(snapshot._registry)) {
+            if (_slot.depth++ == 0) _slot.epoch.store(snapshot._epoch.load());
+            _ptr = snapshot._current.load();
+        }
+        ~Reader() {
+            if (--_slot.depth == 0) _slot.epoch.store(0);
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        const T* get() const { return _ptr; }
+        const T* operator->() const { return _ptr; }
+        const T& operator*() const { return *_ptr; }
+
+    private:
+        SnapshotRegistry::Slot& _slot;
+        const T* _ptr;
+    };
+
+    Snapshot() : Snapshot(T()) {}
+    explicit Snapshot(T initial) : _current(new T(std::move(initial))) {}
+
+    // No reader may be active when the Snapshot is destroyed
+    ~Snapshot() {
+        delete _current.load();
+        for (auto& retired : _retired) delete retired.second;
+    }
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    Reader read() const { return Reader(*this); }
+
+    void publish(T value) { publish(std::unique_ptr<T>(new T(std::move(value)))); }
+
+    void publish(std::unique_ptr<T> value) {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        T* old = _current.exchange(value.release());
+        // Readers that announce this epoch or a later one can only see the new object
+        const uint64_t retiredAt = _epoch.fetch_add(1) + 1;
+        _retired.emplace_back(retiredAt, old);
+        reclaim_locked();
+    }
+
+    // Deletes retired versions no reader can still hold. publish() does this too;
+    // call it to release memory when publishes are rare.
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        reclaim_locked();
+    }
+
+    // Loads path into a fresh object and publishes it. On failure the current
+    // version stays published and false is returned.
+    bool reload(const std::string& path, const Loader& loader) {
+        std::unique_ptr<T> fresh(new T());
+        if (!loader(path, *fresh)) return false;
+        publish(std::move(fresh));
+        return true;
+    }
+
+    bool reload_json(const std::string& path) {
+        return reload(path, [](const std::string& p, T& obj) { return JSON::try_file_to_obj(p, obj); });
+    }
+    bool reload_ini(const std::string& path, const std::string& sectionName = "default") {
+        return reload(path, [&](const std::string& p, T& obj) { return INI::try_file_to_obj(p, obj, sectionName); });
+    }
+    bool reload_xml(const std::string& path, const std::string& rootName = "root") {
+        return reload(path, [&](const std::string& p, T& obj) { return XML::try_file_to_obj(p, obj, rootName); });
+    }
+
+private:
+    void reclaim_locked() {
+        const uint64_t minActive = _registry->min_active_epoch();
+        size_t kept = 0;
+        for (auto& retired : _retired) {
+            if (retired.first <= minActive) delete retired.second;
+            else _retired[kept++] = retired;
+        }
+        _retired.resize(kept);
+    }
+
+    std::atomic<T*> _current;
+    std::atomic<uint64_t> _epoch{1};
+    std::shared_ptr<SnapshotRegistry> _registry = std::make_shared<SnapshotRegistry>();
+    std::mutex _writeMutex;
+    std::vector<std::pair<uint64_t, T*>> _retired; // (epoch retired at, object)
+};
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_SNAPSHOT_H
@@ -0,0 +1,162 @@
+#ifndef O_SERIALIZE_STATS_H
+#define O_SERIALIZE_STATS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace OSerialize {
+
+// Per-call instrumentation of the public serialize/deserialize entry points.
+//
+// Only collected when the library is built with O_SERIALIZE_ENABLE_STATS (CMake
+// option of the same name). That build replaces the global operator new/delete
+// in src/o_serialize.cpp to count heap allocations per thread, and JSON's
+// rapidjson types (JSON::Document, JSON::StringBuffer, ...) allocate through
+// CountingAllocator below, so their malloc/realloc calls are counted too. Not
+// counted: over-aligned operator new, FdWriteStream's posix_memalign buffer, and
+// rapidjson objects the caller creates with rapidjson's default allocator. In
+// this build from_value/to_value take JSON::Value and JSON::Document, not
+// rapidjson::Value and rapidjson::Document. Without the define the accessors
+// below stay zero and the STATS macros compile to nothing.
+//
+//   auto s = OSerialize::JSON::obj_to_string(obj);
+//   const OSerialize::Stats& st = OSerialize::Stats::last();
+//   // st.allocations, st.allocatedBytes, st.jsonPoolBytes, st.outputBytes
+struct Stats {
+    uint64_t calls = 0;
+    uint64_t allocations = 0;      // operator new and CountingAllocator calls
+    uint64_t allocatedBytes = 0;   // bytes requested from either
+    size_t jsonPoolBytes = 0;      // peak rapidjson MemoryPoolAllocator usage
+    size_t xmlBufferBytes = 0;     // peak XMLReader buffer size (the XML path no longer uses tinyxml2's MemPool)
+    size_t outputBytes = 0;        // bytes of serialized output
+
+    // Counts and sizes add up, peaks keep the maximum
+    Stats& operator+=(const Stats& other) {
+        calls += other.calls;
+        allocations += other.allocations;
+        allocatedBytes += other.allocatedBytes;
+        jsonPoolBytes = std::max(jsonPoolBytes, other.jsonPoolBytes);
+        xmlBufferBytes = std::max(xmlBufferBytes, other.xmlBufferBytes);
+        outputBytes += other.outputBytes;
+        return *this;
+    }
+
+    // Stats of the last instrumented call made by this thread
+    static Stats& last() {
+        thread_local Stats stats;
+        return stats;
+    }
+
+    // Sum over all instrumented calls made by this thread since reset()
+    static Stats& accumulated() {
+        thread_local Stats stats;
+        return stats;
+    }
+
+    static void reset() {
+        last() = Stats();
+        accumulated() = Stats();
+    }
+
+#ifdef O_SERIALIZE_ENABLE_STATS
+    struct HeapCounters {
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+
+    // This thread's counters, maintained by the operator new in src/o_serialize.cpp
+    // and by CountingAllocator
+    static HeapCounters& heap();
+
+    // rapidjson base allocator (the CrtAllocator interface) that counts into heap().
+    // A realloc counts as one allocation of the new size, like operator new would.
+    class CountingAllocator {
+    public:
+        static const bool kNeedFree = true;
+        void* Malloc(size_t size) {
+            if (!size) return nullptr;
+            count(size);
+            return std::malloc(size);
+        }
+        void* Realloc(void* originalPtr, size_t originalSize, size_t newSize) {
+            (void)originalSize;
+            if (newSize == 0) {
+                std::free(originalPtr);
+                return nullptr;
+            }
+            count(newSize);
+            return std::realloc(originalPtr, newSize);
+        }
+        static void Free(void* ptr) { std::free(ptr); }
+
+    private:
+        static void count(size_t size) {
+            HeapCounters& counters = heap();
+            ++counters.allocations;
+            counters.bytes += size;
+        }
+    };
+
+    // Marks one public call. Nested scopes (an entry point calling another) are
+    // folded into the outermost one.
+    class Scope {
+    public:
+        Scope() : _outer(depth()++ == 0) {
+            if (!_outer) return;
+            current() = Stats();
+            _start = heap();
+        }
+        ~Scope() {
+            --depth();
+            if (!_outer) return;
+            Stats& stats = current();
+            stats.calls = 1;
+            stats.allocations = heap().allocations - _start.allocations;
+            stats.allocatedBytes = heap().bytes - _start.bytes;
+            last() = stats;
+            accumulated() += stats;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool _outer;
+        HeapCounters _start{};
+    };
+
+    static void record_json_pool(size_t bytes) { current().jsonPoolBytes = std::max(current().jsonPoolBytes, bytes); }
+    static void record_xml_buffer(size_t bytes) { current().xmlBufferBytes = std::max(current().xmlBufferBytes, bytes); }
+    static void record_output(size_t bytes) { current().outputBytes += bytes; }
+
+private:
+    // The call in progress on this thread
+    static Stats& current() {
+        thread_local Stats stats;
+        return stats;
+    }
+
+    static int& depth() {
+        thread_local int value = 0;
+        return value;
+    }
+#endif
+};
+
+} // namespace OSerialize
+
+#ifdef O_SERIALIZE_ENABLE_STATS
+#define O_SERIALIZE_STATS_SCOPE() ::OSerialize::Stats::Scope oSerializeStatsScope
+#define O_SERIALIZE_STATS_JSON_POOL(bytes) ::OSerialize::Stats::record_json_pool(bytes)
+#define O_SERIALIZE_STATS_XML_BUFFER(bytes) ::OSerialize::Stats::record_xml_buffer(bytes)
+#define O_SERIALIZE_STATS_OUTPUT(bytes) ::OSerialize::Stats::record_output(bytes)
+#else
+#define O_SERIALIZE_STATS_SCOPE() ((void)0)
+#define O_SERIALIZE_STATS_JSON_POOL(bytes) ((void)0)
+#define O_SERIALIZE_STATS_XML_BUFFER(bytes) ((void)0)
+#define O_SERIALIZE_STATS_OUTPUT(bytes) ((void)0)
+#endif
+
+#endif // O_SERIALIZE_STATS_H
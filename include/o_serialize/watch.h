@@ -0,0 +1,157 @@
+#ifndef O_SERIALIZE_WATCH_H
+#define O_SERIALIZE_WATCH_H
+
+#include "o_serialize/diff.h"
+#include "o_serialize/json.h"
+#include "o_serialize/ini.h"
+#include "o_serialize/xml.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <climits>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace OSerialize {
+
+// Keeps a config object in sync with its file.
+//
+// The file's directory is watched with inotify, so both in-place writes and
+// editors that replace the file by rename are seen. On change the file is parsed
+// into a fresh object, only the members that differ are moved into the live one
+// (Diff::apply), and subscribers get the dotted paths of the changed fields. A file
+// that fails to load leaves the live object untouched.
+//
+// Not thread-safe: poll() and current() are meant to be used from one thread,
+// e.g. an event loop that also waits on fd().
+template <typename T>
+class ConfigWatcher {
+public:
+    using Loader = std::function<bool(const std::string& path, T& obj)>;
+    using Callback = std::function<void(const T& config, const std::vector<std::string>& changed)>;
+
+    ConfigWatcher(std::string path, Loader loader) : _path(std::move(path)), _loader(std::move(loader)) {
+        const size_t slash = _path.rfind('/');
+        _dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : _path.substr(0, slash));
+        _file = slash == std::string::npos ? _path : _path.substr(slash + 1);
+    }
+
+    ~ConfigWatcher() {
+        if (_fd >= 0) ::close(_fd);
+    }
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    static Loader json() {
+        return [](const std::string& path, T& obj) { return JSON::try_file_to_obj(path, obj); };
+    }
+    static Loader ini(const std::string& sectionName = "default") {
+        return [sectionName](const std::string& path, T& obj) { return INI::try_file_to_obj(path, obj, sectionName); };
+    }
+    static Loader xml(const std::string& rootName = "root") {
+        return [rootName](const std::string& path, T& obj) { return XML::try_file_to_obj(path, obj, rootName); };
+    }
+
+    // Loads the file and starts watching it. Returns false if either fails.
+    bool start() {
+        T fresh;
+        if (!_loader(_path, fresh)) return false;
+        _current = std::move(fresh);
+
+        if (_fd < 0) _fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_fd < 0) return false;
+        return ::inotify_add_watch(_fd, _dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0;
+    }
+
+    // Called with the changed paths after every reload that changed something
+    void subscribe(Callback callback) { _subscribers.push_back({std::string(), std::move(callback)}); }
+
+    // Only called when prefix or a member below it ("db" matches "db.pool.max")
+    // changed, and only with those paths
+    void subscribe(std::string prefix, Callback callback) {
+        _subscribers.push_back({std::move(prefix), std::move(callback)});
+    }
+
+    // Waits up to timeoutMs (-1 = forever) for changes to the file and reloads it.
+    // Returns true if the live object changed.
+    bool poll(int timeoutMs = 0) {
+        if (_fd < 0) return false;
+        pollfd pfd{_fd, POLLIN, 0};
+        int n;
+        while ((n = ::poll(&pfd, 1, timeoutMs)) < 0 && errno == EINTR) {}
+        if (n <= 0) return false;
+
+        bool touched = false;
+        alignas(inotify_event) char buf[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+        ssize_t len;
+        while ((len = ::read(_fd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + len;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                if (event->len > 0 && _file == event->name) touched = true;
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        return touched && reload();
+    }
+
+    // Re-parses the file now and applies the difference. Returns true if the live
+    // object changed.
+    bool reload() {
+        T fresh;
+        if (!_loader(_path, fresh)) return false;
+
+        std::vector<std::string> changed;
+        Diff::apply(_current, std::move(fresh), [&](const std::string& path) { changed.push_back(path); });
+        if (changed.empty()) return false;
+
+        std::vector<std::string> matched;
+        for (const auto& subscriber : _subscribers) {
+            if (subscriber.prefix.empty()) {
+                subscriber.callback(_current, changed);
+                continue;
+            }
+            matched.clear();
+            for (const auto& path : changed) {
+                if (is_under(path, subscriber.prefix)) matched.push_back(path);
+            }
+            if (!matched.empty()) subscriber.callback(_current, matched);
+        }
+        return true;
+    }
+
+    const T& current() const { return _current; }
+
+    // inotify descriptor, readable when poll() has something to do
+    int fd() const { return _fd; }
+
+private:
+    struct Subscriber {
+        std::string prefix;
+        Callback callback;
+    };
+
+    static bool is_under(const std::string& path, const std::string& prefix) {
+        return path.compare(0, prefix.size(), prefix) == 0 &&
+               (path.size() == prefix.size() || path[prefix.size()] == '.');
+    }
+
+    std::string _path;
+    std::string _dir;
+    std::string _file;
+    Loader _loader;
+    T _current{};
+    int _fd = -1;
+    std::vector<Subscriber> _subscribers;
+};
+
+} // namespace OSerialize
+
+#endif // __linux__
+
+#endif // O_SERIALIZE_WATCH_H
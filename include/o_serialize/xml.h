@@ -3,11 +3,25 @@
 
 #include "o_serialize/base.h"
 #include "o_serialize/o_serialize.h"
+#include "o_serialize/number.h"
+#include "o_serialize/options.h"
+#include "o_serialize/stats.h"
+#include "o_serialize/xml_reader.h"
 #include "tinyxml/tinyxml2.h"
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#endif
 
 #ifdef O_SERIALIZE_USE_QT
 #include <QDateTime>
@@ -29,41 +43,268 @@ namespace OSerialize {
 
 class XML {
 public:
+    // Streams obj straight into an XMLPrinter; no tinyxml2 DOM is built.
     template <typename T>
-    static std::string stringify(const T& obj, const std::string& rootName = "root") {
-        tinyxml2::XMLDocument doc;
-        tinyxml2::XMLElement* root = doc.NewElement(rootName.c_str());
-        doc.InsertEndChild(root);
+    static std::string stringify(const T& obj, const std::string& rootName = "root", const WriteOptions& options = WriteOptions::pretty()) {
+        O_SERIALIZE_STATS_SCOPE();
+        Printer printer(nullptr, options);
+        write_root(obj, rootName, printer, options);
+        O_SERIALIZE_STATS_OUTPUT(static_cast<size_t>(printer.CStrSize() - 1));
+        return std::string(printer.CStr(), printer.CStrSize() - 1);
+    }
 
-        to_xml(obj, root, doc);
+    template <typename T>
+    static bool obj_to_file(const T& obj, FILE* file, const std::string& rootName = "root", const WriteOptions& options = WriteOptions::pretty()) {
+        if (!file) return false;
+        O_SERIALIZE_STATS_SCOPE();
+        Printer printer(file, options);
+        write_root(obj, rootName, printer, options);
+        return std::fflush(file) == 0 && !std::ferror(file);
+    }
 
-        tinyxml2::XMLPrinter printer;
-        doc.Print(&printer);
-        return printer.CStr();
+    template <typename T>
+    static bool obj_to_file(const T& obj, const std::string& filepath, const std::string& rootName = "root", const WriteOptions& options = WriteOptions::pretty()) {
+        FILE* file = std::fopen(filepath.c_str(), "wb");
+        if (!file) return false;
+        bool ok = obj_to_file(obj, file, rootName, options);
+        return std::fclose(file) == 0 && ok;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Writes to a file descriptor through a fixed-size buffer. fd is not closed.
+    template <typename T>
+    static bool obj_to_fd(const T& obj, int fd, const std::string& rootName = "root", const WriteOptions& options = WriteOptions::pretty()) {
+        O_SERIALIZE_STATS_SCOPE();
+        FdPrinter printer(fd, options);
+        write_root(obj, rootName, printer, options);
+        bool ok = printer.finish();
+        O_SERIALIZE_STATS_OUTPUT(printer.written());
+        return ok;
     }
+#endif
 
     template <typename T>
     static T parse(const std::string& xml, const std::string& rootName = "root") {
-        tinyxml2::XMLDocument doc;
-        doc.Parse(xml.c_str());
-        
         T obj;
-        if (doc.Error()) {
-            std::cerr << "XML Parse Error: " << doc.ErrorStr() << std::endl;
-            return obj;
+        try_parse(xml, obj, rootName);
+        return obj;
+    }
+
+    // Non-throwing variant of parse(): returns false on malformed XML, a missing
+    // root element, or a value that cannot be converted to its member type.
+    template <typename T>
+    static bool try_parse(const std::string& xml, T& obj, const std::string& rootName = "root") {
+        O_SERIALIZE_STATS_SCOPE();
+        XMLReader reader(xml.data(), xml.size());
+        return read_root(reader, obj, rootName);
+    }
+
+    // Decodes only the top-level members selected by fields; the elements of the
+    // others are skipped by the reader without being converted. Only reflected
+    // roots take a mask, so parse<std::vector<int>>(xml, "items") still resolves
+    // to the overload above.
+    template <typename T>
+    static typename std::enable_if<Meta::has_reflection<T>::value, T>::type
+    parse(const std::string& xml, const FieldMask<T>& fields, const std::string& rootName = "root") {
+        T obj;
+        try_parse(xml, obj, fields, rootName);
+        return obj;
+    }
+
+    template <typename T>
+    static typename std::enable_if<Meta::has_reflection<T>::value, bool>::type
+    try_parse(const std::string& xml, T& obj, const FieldMask<T>& fields, const std::string& rootName = "root") {
+        O_SERIALIZE_STATS_SCOPE();
+        XMLReader reader(xml.data(), xml.size());
+        return read_root(reader, obj, rootName, &fields);
+    }
+
+    // Streams the file through a bounded buffer; no DOM is built.
+    template <typename T>
+    static T file_to_obj(const std::string& filepath, const std::string& rootName = "root") {
+        T obj;
+        try_file_to_obj(filepath, obj, rootName);
+        return obj;
+    }
+
+    // Non-throwing variant of file_to_obj(): returns false if the file cannot be
+    // opened or try_parse() would fail on its contents.
+    template <typename T>
+    static bool try_file_to_obj(const std::string& filepath, T& obj, const std::string& rootName = "root") {
+        O_SERIALIZE_STATS_SCOPE();
+        FILE* file = std::fopen(filepath.c_str(), "rb");
+        if (!file) {
+            std::cerr << "Cannot open file: " << filepath << std::endl;
+            return false;
+        }
+        XMLReader reader(file);
+        bool ok = read_root(reader, obj, rootName);
+        std::fclose(file);
+        return ok;
+    }
+
+    // Decodes the <item> children of the element at `path` (element names from the
+    // root, separated by '/', e.g. "root/orders") one at a time and hands each to
+    // callback(T&&). Only one item is resident at a time, so arbitrarily long
+    // sequences are imported in bounded memory.
+    template <typename T, typename Callback>
+    static bool for_each_item(XMLReader& reader, const std::string& path, Callback&& callback) {
+        O_SERIALIZE_STATS_SCOPE();
+        std::string_view rest(path);
+        while (!rest.empty()) {
+            const size_t slash = rest.find('/');
+            const std::string_view segment = rest.substr(0, slash);
+            bool found = false;
+            while (reader.next_child()) {
+                if (reader.name() == segment) {
+                    found = true;
+                    break;
+                }
+                reader.skip_element();
+            }
+            if (!found) {
+                if (reader.ok()) std::cerr << "XML Parse Error: Element '" << std::string(segment) << "' not found." << std::endl;
+                else std::cerr << "XML Parse Error: " << reader.error_message() << std::endl;
+                return false;
+            }
+            rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
         }
 
-        tinyxml2::XMLElement* root = doc.FirstChildElement(rootName.c_str());
-        if (!root) {
-             std::cerr << "XML Parse Error: Root element '" << rootName << "' not found." << std::endl;
-             return obj;
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() != "item") {
+                reader.skip_element();
+                continue;
+            }
+            T item;
+            ok = from_xml(reader, item) && ok;
+            callback(std::move(item));
+        }
+        O_SERIALIZE_STATS_XML_BUFFER(reader.buffer_size());
+        if (!reader.ok()) {
+            std::cerr << "XML Parse Error: " << reader.error_message() << std::endl;
+            return false;
         }
+        return ok;
+    }
 
-        from_xml(root, obj);
-        return obj;
+    template <typename T, typename Callback>
+    static bool for_each_item(FILE* file, const std::string& path, Callback&& callback) {
+        if (!file) return false;
+        XMLReader reader(file);
+        return for_each_item<T>(reader, path, std::forward<Callback>(callback));
     }
 
 private:
+    template <typename T>
+    static bool read_root(XMLReader& reader, T& obj, const std::string& rootName, const FieldMask<T>* fields = nullptr) {
+        if (!reader.next_child() || reader.name() != rootName) {
+            if (reader.ok()) std::cerr << "XML Parse Error: Root element '" << rootName << "' not found." << std::endl;
+            else std::cerr << "XML Parse Error: " << reader.error_message() << std::endl;
+            return false;
+        }
+
+        bool ok = true;
+        // Containers and scalars can be roots too; only reflected types take a mask
+        if constexpr (Meta::has_reflection<T>::value) ok = fields ? from_xml(reader, obj, *fields) : from_xml(reader, obj);
+        else ok = from_xml(reader, obj);
+        // Check the remainder of the document is well-formed
+        while (reader.next() != XMLReader::EndDocument && reader.ok()) {}
+        O_SERIALIZE_STATS_XML_BUFFER(reader.buffer_size());
+        if (!reader.ok()) {
+            std::cerr << "XML Parse Error: " << reader.error_message() << std::endl;
+            return false;
+        }
+        if (!ok) {
+            std::cerr << "XML Parse Error: Invalid value." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    static void write_root(const T& obj, const std::string& rootName, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml(rootName.c_str(), obj, printer, options);
+    }
+
+    // XMLPrinter indenting with options.indentChar / indentCount instead of four spaces
+    class Printer : public tinyxml2::XMLPrinter {
+    public:
+        Printer(FILE* file, const WriteOptions& options)
+            : tinyxml2::XMLPrinter(file, options.is_compact()), _indent(options.indentCount, options.indentChar) {}
+
+    protected:
+        void PrintSpace(int depth) override {
+            for (int i = 0; i < depth; ++i) Write(_indent.data(), _indent.size());
+        }
+
+    private:
+        std::string _indent;
+    };
+
+#if defined(__unix__) || defined(__APPLE__)
+    // XMLPrinter that buffers its output and flushes it to a file descriptor
+    class FdPrinter : public Printer {
+    public:
+        FdPrinter(int fd, const WriteOptions& options) : Printer(nullptr, options), _fd(fd) {}
+
+        bool finish() {
+            flush();
+            return _ok;
+        }
+
+        size_t written() const { return _written; }
+
+    protected:
+        void Write(const char* data, size_t size) override {
+            if (_size + size > sizeof(_buf)) flush();
+            if (size > sizeof(_buf)) {
+                write_all(data, size);
+                return;
+            }
+            std::memcpy(_buf + _size, data, size);
+            _size += size;
+        }
+
+        void Putc(char ch) override {
+            if (_size == sizeof(_buf)) flush();
+            _buf[_size++] = ch;
+        }
+
+        void Print(const char* format, ...) override {
+            char tmp[256];
+            va_list va;
+            va_start(va, format);
+            int n = std::vsnprintf(tmp, sizeof(tmp), format, va);
+            va_end(va);
+            if (n > 0) Write(tmp, std::min(static_cast<size_t>(n), sizeof(tmp) - 1));
+        }
+
+    private:
+        void flush() {
+            write_all(_buf, _size);
+            _size = 0;
+        }
+
+        void write_all(const char* data, size_t size) {
+            while (_ok && size > 0) {
+                ssize_t n = ::write(_fd, data, size);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) { _ok = false; break; }
+                data += n;
+                size -= static_cast<size_t>(n);
+                _written += static_cast<size_t>(n);
+            }
+        }
+
+        int _fd;
+        bool _ok = true;
+        size_t _size = 0;
+        size_t _written = 0;
+        char _buf[64 * 1024];
+    };
+#endif
+
     // --- Helper for container insert ---
     template <typename C, typename V>
     static auto add_item(C& c, const V& v) -> decltype(c.push_back(v)) { return c.push_back(v); }
@@ -72,170 +313,198 @@ private:
     static auto add_item(C& c, const V& v) -> decltype(c.insert(v)) { return c.insert(v); }
 
     // --- to_xml implementations ---
+    // Members are streamed straight into the printer: the caller has already opened
+    // the element for val, to_xml only writes its text or child elements.
+
+    // Writes <name>val</name>. name must stay alive until the element is closed,
+    // since XMLPrinter keeps the pointer on its stack.
+    template <typename V>
+    static void element_to_xml(const char* name, const V& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        printer.OpenElement(name, options.is_compact());
+        to_xml(val, printer, options);
+        printer.CloseElement(options.is_compact());
+    }
+
+    // Scalar members written as attributes: everything when options.xmlAttributes
+    // is set, otherwise only those listed with O_SERIALIZE_XML_ATTRIBUTES
+    template <typename T>
+    static bool is_attribute(const char* name, const WriteOptions& options) {
+        return options.xmlAttributes || Meta::XmlAttributes<T>::contains(name);
+    }
 
     // Reflected Types
     template <typename T>
     static typename std::enable_if<Meta::has_reflection<T>::value, void>::type
-    to_xml(const T& obj, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        Meta::visit_members(obj, [&](const char* name, const auto& member) {
-            tinyxml2::XMLElement* child = doc.NewElement(name);
-            element->InsertEndChild(child);
-            to_xml(member, child, doc);
+    to_xml(const T& obj, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        // Attributes have to be pushed while the start tag is still open
+        Ordered::visit_members(obj, options, [&](const char* name, const auto& member) {
+            using M = typename std::decay<decltype(member)>::type;
+            if constexpr (Traits::is_text_scalar<M>::value) {
+                if (is_attribute<T>(name, options)) {
+                    with_text(member, options, [&](const char* text) { printer.PushAttribute(name, text); });
+                }
+            }
+        });
+        Ordered::visit_members(obj, options, [&](const char* name, const auto& member) {
+            using M = typename std::decay<decltype(member)>::type;
+            if constexpr (Traits::is_text_scalar<M>::value) {
+                if (is_attribute<T>(name, options)) return;
+            }
+            element_to_xml(name, member, printer, options);
         });
     }
 
-    // Basic Types: stored as text content of the element
+    // Scalars: stored as text content of the element
     template <typename T>
-    static typename std::enable_if<std::is_arithmetic<T>::value, void>::type
-    to_xml(const T& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val);
-    }
-    
-    // Enum Types
-    template <typename T>
-    static typename std::enable_if<std::is_enum<T>::value, void>::type
-    to_xml(T val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText((int)val);
+    static typename std::enable_if<Traits::is_text_scalar<T>::value, void>::type
+    to_xml(const T& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        with_text(val, options, [&](const char* text) { printer.PushText(text); });
+    }
+
+    // with_text() honouring options.maxDecimalPlaces for floating point values
+    template <typename T, typename F>
+    static void with_text(const T& val, const WriteOptions& options, F&& f) {
+        if constexpr (std::is_floating_point<T>::value) {
+            char buf[Number::kBufferSize + 1];
+            *Number::format(buf, buf + Number::kBufferSize, val, options.maxDecimalPlaces) = '\0';
+            f(static_cast<const char*>(buf));
+        } else {
+            with_text(val, f);
+        }
     }
 
-    static void to_xml(const std::string& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val.c_str());
+    // with_text(val, f) calls f with the null-terminated text form of a scalar.
+    // Numbers are formatted with to_chars into a stack buffer.
+    template <typename T, typename F>
+    static typename std::enable_if<(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value>::type
+    with_text(const T& val, F&& f) {
+        char buf[Number::kBufferSize + 1];
+        *Number::format(buf, buf + Number::kBufferSize, val) = '\0';
+        f(static_cast<const char*>(buf));
     }
 
-    static void to_xml(const char* val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val);
+    template <typename F>
+    static void with_text(bool val, F&& f) { f(val ? "true" : "false"); }
+
+    template <typename F>
+    static void with_text(const std::string& val, F&& f) { f(val.c_str()); }
+
+#ifdef O_SERIALIZE_USE_QT
+    template <typename F>
+    static void with_text(const QString& val, F&& f) { f(val.toUtf8().constData()); }
+
+    // Qt Date/Time
+    template <typename F>
+    static void with_text(const QDate& val, F&& f) { f(val.toString(Qt::ISODate).toUtf8().constData()); }
+    template <typename F>
+    static void with_text(const QTime& val, F&& f) { f(val.toString(Qt::ISODate).toUtf8().constData()); }
+    template <typename F>
+    static void with_text(const QDateTime& val, F&& f) { f(val.toString(Qt::ISODate).toUtf8().constData()); }
+
+    template <typename F>
+    static void with_text(const QColor& val, F&& f) { f(val.name().toUtf8().constData()); }
+    template <typename F>
+    static void with_text(const QByteArray& val, F&& f) { f(val.toStdString().c_str()); }
+#endif
+
+    static void to_xml(const char* val, tinyxml2::XMLPrinter& printer, const WriteOptions&) {
+        printer.PushText(val);
     }
 
     // Smart Pointers
     template <typename T>
     static typename std::enable_if<Traits::is_smart_ptr<T>::value, void>::type
-    to_xml(const T& ptr, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
+    to_xml(const T& ptr, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
         if (ptr) {
-            to_xml(*ptr, element, doc);
+            to_xml(*ptr, printer, options);
         }
         // If null, we leave empty or add explicit null attribute? XML usually just empty or missing.
     }
 
     // Variant
     template <typename... Args>
-    static void to_xml(const std::variant<Args...>& v, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
+    static void to_xml(const std::variant<Args...>& v, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
         std::visit([&](const auto& val) {
-            to_xml(val, element, doc);
+            to_xml(val, printer, options);
         }, v);
     }
 
 #ifdef O_SERIALIZE_USE_QT
-    static void to_xml(const QString& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val.toUtf8().constData());
+    // Qt Geometry
+    static void to_xml(const QPoint& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml("x", val.x(), printer, options);
+        element_to_xml("y", val.y(), printer, options);
     }
-
-    // Qt Date/Time
-    static void to_xml(const QDate& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val.toString(Qt::ISODate).toUtf8().constData());
+    static void to_xml(const QPointF& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml("x", val.x(), printer, options);
+        element_to_xml("y", val.y(), printer, options);
     }
-    static void to_xml(const QTime& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val.toString(Qt::ISODate).toUtf8().constData());
+    static void to_xml(const QSize& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml("width", val.width(), printer, options);
+        element_to_xml("height", val.height(), printer, options);
     }
-    static void to_xml(const QDateTime& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val.toString(Qt::ISODate).toUtf8().constData());
+    static void to_xml(const QSizeF& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml("width", val.width(), printer, options);
+        element_to_xml("height", val.height(), printer, options);
     }
-
-    // Qt Geometry
-    static void to_xml(const QPoint& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        tinyxml2::XMLElement* x = doc.NewElement("x"); x->SetText(val.x()); element->InsertEndChild(x);
-        tinyxml2::XMLElement* y = doc.NewElement("y"); y->SetText(val.y()); element->InsertEndChild(y);
-    }
-    static void to_xml(const QPointF& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        tinyxml2::XMLElement* x = doc.NewElement("x"); x->SetText(val.x()); element->InsertEndChild(x);
-        tinyxml2::XMLElement* y = doc.NewElement("y"); y->SetText(val.y()); element->InsertEndChild(y);
-    }
-    static void to_xml(const QSize& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        tinyxml2::XMLElement* w = doc.NewElement("width"); w->SetText(val.width()); element->InsertEndChild(w);
-        tinyxml2::XMLElement* h = doc.NewElement("height"); h->SetText(val.height()); element->InsertEndChild(h);
-    }
-    static void to_xml(const QSizeF& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        tinyxml2::XMLElement* w = doc.NewElement("width"); w->SetText(val.width()); element->InsertEndChild(w);
-        tinyxml2::XMLElement* h = doc.NewElement("height"); h->SetText(val.height()); element->InsertEndChild(h);
-    }
-    static void to_xml(const QRect& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        tinyxml2::XMLElement* x = doc.NewElement("x"); x->SetText(val.x()); element->InsertEndChild(x);
-        tinyxml2::XMLElement* y = doc.NewElement("y"); y->SetText(val.y()); element->InsertEndChild(y);
-        tinyxml2::XMLElement* w = doc.NewElement("width"); w->SetText(val.width()); element->InsertEndChild(w);
-        tinyxml2::XMLElement* h = doc.NewElement("height"); h->SetText(val.height()); element->InsertEndChild(h);
-    }
-    static void to_xml(const QRectF& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        tinyxml2::XMLElement* x = doc.NewElement("x"); x->SetText(val.x()); element->InsertEndChild(x);
-        tinyxml2::XMLElement* y = doc.NewElement("y"); y->SetText(val.y()); element->InsertEndChild(y);
-        tinyxml2::XMLElement* w = doc.NewElement("width"); w->SetText(val.width()); element->InsertEndChild(w);
-        tinyxml2::XMLElement* h = doc.NewElement("height"); h->SetText(val.height()); element->InsertEndChild(h);
+    static void to_xml(const QRect& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml("x", val.x(), printer, options);
+        element_to_xml("y", val.y(), printer, options);
+        element_to_xml("width", val.width(), printer, options);
+        element_to_xml("height", val.height(), printer, options);
     }
-    
-    static void to_xml(const QColor& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val.name().toUtf8().constData());
-    }
-    
-    static void to_xml(const QByteArray& val, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        element->SetText(val.toStdString().c_str());
+    static void to_xml(const QRectF& val, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml("x", val.x(), printer, options);
+        element_to_xml("y", val.y(), printer, options);
+        element_to_xml("width", val.width(), printer, options);
+        element_to_xml("height", val.height(), printer, options);
     }
 
     // Qt Smart Pointers
     template <typename T>
     static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value, void>::type
-    to_xml(const T& ptr, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
+    to_xml(const T& ptr, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
         if (ptr) {
-            to_xml(*ptr, element, doc);
+            to_xml(*ptr, printer, options);
         }
     }
 
     // QPair
     template <typename T>
     static typename std::enable_if<Traits::is_qpair<T>::value, void>::type
-    to_xml(const T& pair, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        tinyxml2::XMLElement* first = doc.NewElement("first");
-        element->InsertEndChild(first);
-        to_xml(pair.first, first, doc);
-
-        tinyxml2::XMLElement* second = doc.NewElement("second");
-        element->InsertEndChild(second);
-        to_xml(pair.second, second, doc);
+    to_xml(const T& pair, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        element_to_xml("first", pair.first, printer, options);
+        element_to_xml("second", pair.second, printer, options);
     }
 #endif
 
     // STL/Qt Container (Vector, List, Set)
     template <typename T>
     static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, void>::type
-    to_xml(const T& container, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
+    to_xml(const T& container, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
         for (const auto& item : container) {
-            tinyxml2::XMLElement* child = doc.NewElement("item");
-            element->InsertEndChild(child);
-            to_xml(item, child, doc);
+            element_to_xml("item", item, printer, options);
         }
     }
 
     // STL Map (Key must be string-like)
     template <typename T>
     static typename std::enable_if<Traits::is_stl_map<T>::value, void>::type
-    to_xml(const T& map, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        for (const auto& pair : map) {
-            tinyxml2::XMLElement* child = doc.NewElement(pair.first.c_str());
-            element->InsertEndChild(child);
-            to_xml(pair.second, child, doc);
-        }
+    to_xml(const T& map, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        Ordered::for_each_entry(map, options, [&](const auto& key, const auto& value) {
+            element_to_xml(key.c_str(), value, printer, options);
+        });
     }
 
 #ifdef O_SERIALIZE_USE_QT
     // Qt Map
     template <typename T>
     static typename std::enable_if<Traits::is_qt_map<T>::value, void>::type
-    to_xml(const T& map, tinyxml2::XMLElement* element, tinyxml2::XMLDocument& doc) {
-        auto it = map.begin();
-        while (it != map.end()) {
-            // Qt Map iterator: key() and value()
-            tinyxml2::XMLElement* child = doc.NewElement(val_to_string_helper(it.key()).c_str());
-            element->InsertEndChild(child);
-            to_xml(it.value(), child, doc);
-            ++it;
-        }
+    to_xml(const T& map, tinyxml2::XMLPrinter& printer, const WriteOptions& options) {
+        Ordered::for_each_entry(map, options, [&](const auto& key, const auto& value) {
+            const std::string name = val_to_string_helper(key);
+            element_to_xml(name.c_str(), value, printer, options);
+        });
     }
 
     // Helper for Map Keys
@@ -246,234 +515,263 @@ private:
 #endif
 
     // --- from_xml implementations ---
+    // Each overload is entered with the reader positioned on the start tag of the
+    // element holding val and consumes everything up to and including its end tag.
+    // It returns false when a value could not be converted; decoding carries on
+    // with the remaining members, so one bad field does not lose the rest.
 
     // Reflected Types
     template <typename T>
-    static typename std::enable_if<Meta::has_reflection<T>::value>::type
-    from_xml(tinyxml2::XMLElement* element, T& obj) {
-        if (!element) return;
-        Meta::visit_members(obj, [&](const char* name, auto& member) {
-            tinyxml2::XMLElement* child = element->FirstChildElement(name);
-            if (child) {
-                from_xml(child, member);
-            }
-        });
+    static typename std::enable_if<Meta::has_reflection<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& obj) {
+        return from_xml(reader, obj, [](size_t) { return true; });
     }
 
-    // Basic Types
-    static void from_xml(tinyxml2::XMLElement* element, int& val) { 
-        if(element && element->GetText()) val = std::stoi(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, unsigned int& val) { 
-        if(element && element->GetText()) val = std::stoul(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, long& val) { 
-        if(element && element->GetText()) val = std::stol(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, unsigned long& val) { 
-        if(element && element->GetText()) val = std::stoul(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, long long& val) { 
-        if(element && element->GetText()) val = std::stoll(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, unsigned long long& val) { 
-        if(element && element->GetText()) val = std::stoull(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, double& val) { 
-        if(element && element->GetText()) val = std::stod(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, float& val) { 
-        if(element && element->GetText()) val = std::stof(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, bool& val) { 
-        if(element && element->GetText()) {
-            std::string text = element->GetText();
-            val = (text == "true" || text == "1");
+    // Reflected types, reading only the members in fields
+    template <typename T>
+    static typename std::enable_if<Meta::has_reflection<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& obj, const FieldMask<T>& fields) {
+        return from_xml(reader, obj, [&](size_t index) { return fields.contains(index); });
+    }
+
+    // wanted(index) selects members by declaration index; unwanted elements are
+    // skipped whole
+    template <typename T, typename Wanted>
+    static typename std::enable_if<Meta::has_reflection<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& obj, Wanted&& wanted) {
+        bool ok = true;
+        // Scalar members may come as attributes of the start tag, either encoding
+        // is accepted. They must be read before the reader advances.
+        if (reader.has_attributes()) {
+            size_t index = 0;
+            Meta::visit_members(obj, [&](const char* memberName, auto& member) {
+                using M = typename std::decay<decltype(member)>::type;
+                if constexpr (Traits::is_text_scalar<M>::value) {
+                    std::string_view text;
+                    if (wanted(index) && reader.attribute(memberName, text)) ok = from_text(text, member) && ok;
+                }
+                ++index;
+            });
         }
+        while (reader.next_child()) {
+            const std::string_view name = reader.name();
+            bool matched = false;
+            size_t index = 0;
+            Meta::visit_members(obj, [&](const char* memberName, auto& member) {
+                if (!matched && name == memberName) {
+                    matched = true;
+                    if (wanted(index)) ok = from_xml(reader, member) && ok;
+                    else reader.skip_element();
+                }
+                ++index;
+            });
+            if (!matched) reader.skip_element();
+        }
+        return ok;
     }
-    // int8_t / uint8_t
-    static void from_xml(tinyxml2::XMLElement* element, signed char& val) { 
-        if(element && element->GetText()) val = (signed char)std::stoi(element->GetText()); 
-    }
-    static void from_xml(tinyxml2::XMLElement* element, unsigned char& val) { 
-        if(element && element->GetText()) val = (unsigned char)std::stoul(element->GetText()); 
+
+    // Scalars: decoded from the element text; an empty element keeps the default
+    template <typename T>
+    static typename std::enable_if<Traits::is_text_scalar<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& val) {
+        std::string_view text;
+        if (!reader.read_text(text)) return true;
+        return from_text(text, val);
     }
-    // Enum
+
+    // from_text(text, val) converts element text or an attribute value.
+    // Numbers are parsed in place with from_chars.
     template <typename T>
-    static typename std::enable_if<std::is_enum<T>::value>::type
-    from_xml(tinyxml2::XMLElement* element, T& val) {
-        if(element && element->GetText()) val = static_cast<T>(std::stoi(element->GetText()));
+    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, bool>::type
+    from_text(std::string_view text, T& val) {
+        return Number::parse(text.data(), text.data() + text.size(), val);
     }
-    
-    static void from_xml(tinyxml2::XMLElement* element, std::string& val) { 
-        if(element && element->GetText()) val = element->GetText(); 
+
+    static bool from_text(std::string_view text, std::string& val) {
+        val.assign(text.data(), text.size());
+        return true;
     }
 
     // Smart Pointers
     template <typename T>
-    static typename std::enable_if<Traits::is_smart_ptr<T>::value>::type
-    from_xml(tinyxml2::XMLElement* element, T& ptr) {
-        if (!element) {
-            ptr.reset();
-            return;
-        }
+    static typename std::enable_if<Traits::is_smart_ptr<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& ptr) {
         using ElementType = typename T::element_type;
         ptr = std::make_shared<ElementType>(); 
-        from_xml(element, *ptr);
+        return from_xml(reader, *ptr);
     }
 
 #ifdef O_SERIALIZE_USE_QT
-    static void from_xml(tinyxml2::XMLElement* element, QString& val) {
-        if(element && element->GetText()) val = QString::fromUtf8(element->GetText());
+    static bool from_text(std::string_view text, QString& val) {
+        val = QString::fromUtf8(text.data(), (int)text.size());
+        return true;
     }
 
-    static void from_xml(tinyxml2::XMLElement* element, QDate& val) {
-        if(element && element->GetText()) val = QDate::fromString(QString::fromUtf8(element->GetText()), Qt::ISODate);
+    static bool from_text(std::string_view text, QDate& val) {
+        val = QDate::fromString(QString::fromUtf8(text.data(), (int)text.size()), Qt::ISODate);
+        return true;
     }
-    static void from_xml(tinyxml2::XMLElement* element, QTime& val) {
-        if(element && element->GetText()) val = QTime::fromString(QString::fromUtf8(element->GetText()), Qt::ISODate);
+    static bool from_text(std::string_view text, QTime& val) {
+        val = QTime::fromString(QString::fromUtf8(text.data(), (int)text.size()), Qt::ISODate);
+        return true;
     }
-    static void from_xml(tinyxml2::XMLElement* element, QDateTime& val) {
-        if(element && element->GetText()) val = QDateTime::fromString(QString::fromUtf8(element->GetText()), Qt::ISODate);
+    static bool from_text(std::string_view text, QDateTime& val) {
+        val = QDateTime::fromString(QString::fromUtf8(text.data(), (int)text.size()), Qt::ISODate);
+        return true;
     }
 
-    static void from_xml(tinyxml2::XMLElement* element, QPoint& val) {
-        if(element) {
-            tinyxml2::XMLElement* c = element->FirstChildElement("x"); if(c) from_xml(c, val.rx());
-            c = element->FirstChildElement("y"); if(c) from_xml(c, val.ry());
-        }
+    static bool from_text(std::string_view text, QColor& val) {
+        val.setNamedColor(QString::fromUtf8(text.data(), (int)text.size()));
+        return true;
     }
-    static void from_xml(tinyxml2::XMLElement* element, QPointF& val) {
-        if(element) {
-            tinyxml2::XMLElement* c = element->FirstChildElement("x"); if(c) from_xml(c, val.rx());
-            c = element->FirstChildElement("y"); if(c) from_xml(c, val.ry());
-        }
+
+    static bool from_text(std::string_view text, QByteArray& val) {
+        val = QByteArray(text.data(), (int)text.size());
+        return true;
     }
-    static void from_xml(tinyxml2::XMLElement* element, QSize& val) {
-        if(element) {
-            tinyxml2::XMLElement* c = element->FirstChildElement("width"); if(c) from_xml(c, val.rwidth());
-            c = element->FirstChildElement("height"); if(c) from_xml(c, val.rheight());
+
+    static bool from_xml(XMLReader& reader, QPoint& val) {
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() == "x") ok = from_xml(reader, val.rx()) && ok;
+            else if (reader.name() == "y") ok = from_xml(reader, val.ry()) && ok;
+            else reader.skip_element();
         }
-    }
-    static void from_xml(tinyxml2::XMLElement* element, QSizeF& val) {
-        if(element) {
-            tinyxml2::XMLElement* c = element->FirstChildElement("width"); if(c) from_xml(c, val.rwidth());
-            c = element->FirstChildElement("height"); if(c) from_xml(c, val.rheight());
+        return ok;
+    }
+    static bool from_xml(XMLReader& reader, QPointF& val) {
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() == "x") ok = from_xml(reader, val.rx()) && ok;
+            else if (reader.name() == "y") ok = from_xml(reader, val.ry()) && ok;
+            else reader.skip_element();
         }
-    }
-    static void from_xml(tinyxml2::XMLElement* element, QRect& val) {
-        if(element) {
-            int x=0,y=0,w=0,h=0;
-            tinyxml2::XMLElement* c = element->FirstChildElement("x"); if(c) from_xml(c, x);
-            c = element->FirstChildElement("y"); if(c) from_xml(c, y);
-            c = element->FirstChildElement("width"); if(c) from_xml(c, w);
-            c = element->FirstChildElement("height"); if(c) from_xml(c, h);
-            val.setRect(x,y,w,h);
+        return ok;
+    }
+    static bool from_xml(XMLReader& reader, QSize& val) {
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() == "width") ok = from_xml(reader, val.rwidth()) && ok;
+            else if (reader.name() == "height") ok = from_xml(reader, val.rheight()) && ok;
+            else reader.skip_element();
         }
-    }
-    static void from_xml(tinyxml2::XMLElement* element, QRectF& val) {
-        if(element) {
-            double x=0,y=0,w=0,h=0;
-            tinyxml2::XMLElement* c = element->FirstChildElement("x"); if(c) from_xml(c, x);
-            c = element->FirstChildElement("y"); if(c) from_xml(c, y);
-            c = element->FirstChildElement("width"); if(c) from_xml(c, w);
-            c = element->FirstChildElement("height"); if(c) from_xml(c, h);
-            val.setRect(x,y,w,h);
+        return ok;
+    }
+    static bool from_xml(XMLReader& reader, QSizeF& val) {
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() == "width") ok = from_xml(reader, val.rwidth()) && ok;
+            else if (reader.name() == "height") ok = from_xml(reader, val.rheight()) && ok;
+            else reader.skip_element();
         }
-    }
-    
-    static void from_xml(tinyxml2::XMLElement* element, QColor& val) {
-        if(element && element->GetText()) val.setNamedColor(QString::fromUtf8(element->GetText()));
-    }
-    
-    static void from_xml(tinyxml2::XMLElement* element, QByteArray& val) {
-        if(element && element->GetText()) val = QByteArray(element->GetText());
+        return ok;
+    }
+    static bool from_xml(XMLReader& reader, QRect& val) {
+        int x=0,y=0,w=0,h=0;
+        bool ok = rect_from_xml(reader, x, y, w, h);
+        val.setRect(x,y,w,h);
+        return ok;
+    }
+    static bool from_xml(XMLReader& reader, QRectF& val) {
+        double x=0,y=0,w=0,h=0;
+        bool ok = rect_from_xml(reader, x, y, w, h);
+        val.setRect(x,y,w,h);
+        return ok;
+    }
+
+    template <typename V>
+    static bool rect_from_xml(XMLReader& reader, V& x, V& y, V& w, V& h) {
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() == "x") ok = from_xml(reader, x) && ok;
+            else if (reader.name() == "y") ok = from_xml(reader, y) && ok;
+            else if (reader.name() == "width") ok = from_xml(reader, w) && ok;
+            else if (reader.name() == "height") ok = from_xml(reader, h) && ok;
+            else reader.skip_element();
+        }
+        return ok;
     }
 
     // Qt Smart Pointers
     template <typename T>
-    static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value>::type
-    from_xml(tinyxml2::XMLElement* element, T& ptr) {
-        if (!element) {
-            ptr.reset();
-            return;
-        }
-        create_qt_smart_ptr_xml(ptr, element);
+    static typename std::enable_if<Traits::is_qt_smart_ptr<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& ptr) {
+        return create_qt_smart_ptr_xml(ptr, reader);
     }
 
     // Helpers for creating Qt smart pointers (XML)
     template <typename T>
-    static auto create_qt_smart_ptr_xml(QSharedPointer<T>& ptr, tinyxml2::XMLElement* element) -> void {
+    static auto create_qt_smart_ptr_xml(QSharedPointer<T>& ptr, XMLReader& reader) -> bool {
         ptr = QSharedPointer<T>::create();
-        from_xml(element, *ptr);
+        return from_xml(reader, *ptr);
     }
     
     template <typename T>
-    static auto create_qt_smart_ptr_xml(QScopedPointer<T>& ptr, tinyxml2::XMLElement* element) -> void {
+    static auto create_qt_smart_ptr_xml(QScopedPointer<T>& ptr, XMLReader& reader) -> bool {
         ptr.reset(new T());
-        from_xml(element, *ptr);
+        return from_xml(reader, *ptr);
     }
     
     template <typename T>
-    static auto create_qt_smart_ptr_xml(QPointer<T>& ptr, tinyxml2::XMLElement*) -> void {
+    static auto create_qt_smart_ptr_xml(QPointer<T>& ptr, XMLReader& reader) -> bool {
         ptr = nullptr;
+        reader.skip_element();
+        return true;
     }
 
     // QPair
     template <typename T>
-    static typename std::enable_if<Traits::is_qpair<T>::value>::type
-    from_xml(tinyxml2::XMLElement* element, T& pair) {
-        if (!element) return;
-        tinyxml2::XMLElement* first = element->FirstChildElement("first");
-        if (first) from_xml(first, pair.first);
-        
-        tinyxml2::XMLElement* second = element->FirstChildElement("second");
-        if (second) from_xml(second, pair.second);
+    static typename std::enable_if<Traits::is_qpair<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& pair) {
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() == "first") ok = from_xml(reader, pair.first) && ok;
+            else if (reader.name() == "second") ok = from_xml(reader, pair.second) && ok;
+            else reader.skip_element();
+        }
+        return ok;
     }
 #endif
 
-    // STL/Qt Container
+    // STL/Qt Container: each <item> is decoded and inserted as soon as it is read
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value>::type
-    from_xml(tinyxml2::XMLElement* element, T& container) {
-        if (!element) return;
+    static typename std::enable_if<Traits::is_stl_container<T>::value || Traits::is_qt_container<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& container) {
         container.clear();
-        tinyxml2::XMLElement* child = element->FirstChildElement("item");
-        while (child) {
+        bool ok = true;
+        while (reader.next_child()) {
+            if (reader.name() != "item") {
+                reader.skip_element();
+                continue;
+            }
             typename T::value_type val;
-            from_xml(child, val);
+            ok = from_xml(reader, val) && ok;
             add_item(container, val);
-            child = child->NextSiblingElement("item");
         }
+        return ok;
     }
 
     // STL/Qt Map
     template <typename T>
-    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value>::type
-    from_xml(tinyxml2::XMLElement* element, T& map) {
-        if (!element) return;
+    static typename std::enable_if<Traits::is_stl_map<T>::value || Traits::is_qt_map<T>::value, bool>::type
+    from_xml(XMLReader& reader, T& map) {
         map.clear();
-        tinyxml2::XMLElement* child = element->FirstChildElement();
-        while (child) {
+        bool ok = true;
+        while (reader.next_child()) {
+            // The element name is only valid until the value is read
+            typename T::key_type key{};
+            const bool keyOk = key_from_string(reader.name(), key);
             typename T::mapped_type val;
-            from_xml(child, val);
-            // QMap supports operator[] with implicit string conversion
-            insert_map_item(map, child->Name(), val);
-            child = child->NextSiblingElement();
+            ok = from_xml(reader, val) && keyOk && ok;
+            if (keyOk) map[key] = val;
         }
+        return ok;
     }
     
     template <typename T>
-    static T key_from_string(const char* key) {
-        if constexpr (std::is_integral<T>::value) return static_cast<T>(std::atoll(key));
-        else if constexpr (std::is_floating_point<T>::value) return static_cast<T>(std::atof(key));
-        else return T(key);
-    }
-    
-    // Helper to insert into map
-    template <typename Map, typename Val>
-    static void insert_map_item(Map& map, const char* key, const Val& val) {
-        map[key_from_string<typename Map::key_type>(key)] = val;
+    static bool key_from_string(std::string_view key, T& out) {
+        if constexpr (std::is_arithmetic<T>::value) return Number::parse(key.data(), key.data() + key.size(), out);
+        else { out = T(std::string(key).c_str()); return true; }
     }
 };
 
@@ -0,0 +1,501 @@
+#ifndef O_SERIALIZE_XML_READER_H
+#define O_SERIALIZE_XML_READER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace OSerialize {
+
+// Pull (StAX-style) XML reader.
+// Input is pulled chunk by chunk from memory or a FILE* into one reusable buffer
+// that only has to hold the largest single token, never the whole document.
+// Views returned by name(), text() and attribute() stay valid until the reader
+// is advanced again.
+class XMLReader {
+public:
+    enum Event { None, StartElement, EndElement, Text, EndDocument, Error };
+
+    static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+    explicit XMLReader(FILE* file, size_t bufferSize = kDefaultBufferSize)
+        : _file(file), _buf(std::max<size_t>(bufferSize, 16)) {}
+
+    XMLReader(const char* data, size_t size, size_t bufferSize = kDefaultBufferSize)
+        : _data(data), _dataSize(size), _buf(std::max<size_t>(std::min(size, bufferSize), 16)) {}
+
+    Event event() const { return _event; }
+    bool ok() const { return _event != Error; }
+    const std::string& error_message() const { return _error; }
+
+    // Number of open elements; 1 while positioned inside the root element
+    int depth() const { return _depth; }
+
+    // Element name of the current StartElement / EndElement
+    std::string_view name() const { return view(_nameOff, _nameLen); }
+
+    // Entity-decoded content of the current Text event
+    std::string_view text() const { return view(_textOff, _textLen); }
+
+    bool has_attributes() const { return !_attrs.empty(); }
+
+    // Current size of the internal buffer; grows only for tokens that do not fit
+    size_t buffer_size() const { return _buf.size(); }
+
+    // Attribute of the current StartElement; returns false if it is absent
+    bool attribute(std::string_view attrName, std::string_view& value) const {
+        for (const auto& attr : _attrs) {
+            if (view(attr.nameOff, attr.nameLen) == attrName) {
+                value = view(attr.valueOff, attr.valueLen);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void fail(const std::string& message) {
+        if (_event == Error) return;
+        _event = Error;
+        _error = message;
+    }
+
+    // Advances to the next event. Comments, processing instructions, DOCTYPE and
+    // whitespace-only text are skipped; <a/> yields StartElement then EndElement.
+    Event next() {
+        if (_event == Error || _event == EndDocument) return _event;
+        _attrs.clear();
+        if (_pendingEnd) {
+            _pendingEnd = false;
+            --_depth;
+            return _event = EndElement;
+        }
+        if (!_started) {
+            _started = true;
+            ensure(3);
+            if (avail() >= 3 && std::memcmp(cur(), "\xEF\xBB\xBF", 3) == 0) _pos += 3;
+        }
+        for (;;) {
+            if (!ensure(1)) {
+                if (_depth > 0) fail("unexpected end of document");
+                else _event = EndDocument;
+                return _event;
+            }
+            if (*cur() != '<') {
+                size_t lt = find("<", 0);
+                size_t len = lt == npos ? avail() : lt;
+                size_t off = _pos;
+                _pos += len;
+                if (is_blank(_buf.data() + off, len)) continue;
+                if (_depth == 0) {
+                    fail("text outside of the root element");
+                    return _event;
+                }
+                _textOff = off;
+                _textLen = decode(_buf.data() + off, _buf.data() + off + len);
+                return _event = Text;
+            }
+            if (!ensure(2)) {
+                fail("unexpected end of document");
+                return _event;
+            }
+            char c = cur()[1];
+            if (c == '?') {
+                if (!skip_past("?>", 2)) return _event;
+                continue;
+            }
+            if (c == '!') {
+                if (ensure(4) && std::memcmp(cur(), "<!--", 4) == 0) {
+                    if (!skip_past("-->", 4)) return _event;
+                    continue;
+                }
+                if (ensure(9) && std::memcmp(cur(), "<![CDATA[", 9) == 0) {
+                    size_t end = find("]]>", 9);
+                    if (end == npos) {
+                        fail("unterminated CDATA section");
+                        return _event;
+                    }
+                    if (_depth == 0) {
+                        fail("CDATA outside of the root element");
+                        return _event;
+                    }
+                    _textOff = _pos + 9;
+                    _textLen = end - 9;
+                    _pos += end + 3;
+                    return _event = Text;
+                }
+                if (!skip_declaration()) return _event;
+                continue;
+            }
+            if (c == '/') return read_end_tag();
+            return read_start_tag();
+        }
+    }
+
+    // Moves to the next child element of the element the reader is positioned in.
+    // Returns false once that element's end tag has been consumed (or on error).
+    bool next_child() {
+        const int parent = _depth;
+        for (;;) {
+            switch (next()) {
+            case StartElement:
+                if (_depth == parent + 1) return true;
+                skip_element();
+                break;
+            case EndElement:
+                if (_depth < parent) return false;
+                break;
+            case Text:
+                break;
+            default:
+                return false;
+            }
+        }
+    }
+
+    // Consumes the current element and returns its text content. Child elements
+    // are skipped. Returns false if the element has no text.
+    bool read_text(std::string_view& out) {
+        const int d = _depth;
+        bool have = false;
+        bool joined = false;
+        size_t len = 0;
+        for (;;) {
+            Event e = next();
+            if (e == Text) {
+                if (!have) {
+                    have = true;
+                    _pinned = true;
+                    _pin = _textOff;
+                    len = _textLen;
+                } else {
+                    if (!joined) {
+                        _scratch.assign(_buf.data() + _pin, len);
+                        joined = true;
+                    }
+                    _scratch.append(text());
+                }
+            } else if (e == StartElement) {
+                skip_element();
+            } else if (e != EndElement || _depth < d) {
+                break;
+            }
+        }
+        _pinned = false;
+        if (!have || !ok()) return false;
+        out = joined ? std::string_view(_scratch) : view(_pin, len);
+        return true;
+    }
+
+    // Consumes the current element, including all of its descendants
+    void skip_element() {
+        const int d = _depth;
+        for (;;) {
+            Event e = next();
+            if ((e == EndElement && _depth < d) || e == Error || e == EndDocument) return;
+        }
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct Attribute {
+        size_t nameOff, nameLen, valueOff, valueLen;
+    };
+
+    std::string_view view(size_t off, size_t len) const { return std::string_view(_buf.data() + off, len); }
+    char* cur() { return _buf.data() + _pos; }
+    size_t avail() const { return _end - _pos; }
+
+    static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    static bool is_blank(const char* p, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (!is_space(p[i])) return false;
+        }
+        return true;
+    }
+
+    size_t read_source(char* dst, size_t cap) {
+        if (_file) return std::fread(dst, 1, cap, _file);
+        size_t n = std::min(cap, _dataSize - _dataPos);
+        std::memcpy(dst, _data + _dataPos, n);
+        _dataPos += n;
+        return n;
+    }
+
+    // Drops consumed bytes, grows the buffer only when a single token fills it,
+    // and reads the next chunk. Offsets relative to _pos stay valid.
+    bool fill_more() {
+        if (_eof) return false;
+        size_t keep = _pinned ? std::min(_pin, _pos) : _pos;
+        if (keep > 0) {
+            std::memmove(_buf.data(), _buf.data() + keep, _end - keep);
+            _end -= keep;
+            _pos -= keep;
+            if (_pinned) _pin -= keep;
+        }
+        if (_end == _buf.size()) _buf.resize(_buf.size() * 2);
+        size_t n = read_source(_buf.data() + _end, _buf.size() - _end);
+        if (n == 0) {
+            _eof = true;
+            return false;
+        }
+        _end += n;
+        return true;
+    }
+
+    bool ensure(size_t n) {
+        while (avail() < n) {
+            if (!fill_more()) return false;
+        }
+        return true;
+    }
+
+    // Offset of pattern relative to _pos, searching from `from`; npos at end of input
+    size_t find(const char* pattern, size_t from) {
+        const size_t plen = std::strlen(pattern);
+        for (;;) {
+            const char* base = _buf.data() + _pos;
+            const size_t n = avail();
+            if (plen == 1) {
+                if (from < n) {
+                    const void* hit = std::memchr(base + from, pattern[0], n - from);
+                    if (hit) return static_cast<const char*>(hit) - base;
+                }
+                from = std::max(from, n);
+            } else if (n >= plen) {
+                for (size_t i = from; i + plen <= n; ++i) {
+                    if (base[i] == pattern[0] && std::memcmp(base + i, pattern, plen) == 0) return i;
+                }
+                from = std::max(from, n - plen + 1);
+            }
+            if (!fill_more()) return npos;
+        }
+    }
+
+    bool skip_past(const char* pattern, size_t from) {
+        size_t end = find(pattern, from);
+        if (end == npos) {
+            fail("unterminated markup");
+            return false;
+        }
+        _pos += end + std::strlen(pattern);
+        return true;
+    }
+
+    // <!DOCTYPE ...> with an optional [internal subset]
+    bool skip_declaration() {
+        size_t i = 2;
+        int brackets = 0;
+        for (;;) {
+            const char* base = _buf.data() + _pos;
+            for (const size_t n = avail(); i < n; ++i) {
+                if (base[i] == '[') ++brackets;
+                else if (base[i] == ']') --brackets;
+                else if (base[i] == '>' && brackets <= 0) {
+                    _pos += i + 1;
+                    return true;
+                }
+            }
+            if (!fill_more()) {
+                fail("unterminated declaration");
+                return false;
+            }
+        }
+    }
+
+    // Offset of the '>' closing a start tag, ignoring '>' inside quoted attribute values
+    size_t find_tag_end() {
+        size_t i = 1;
+        char quote = 0;
+        for (;;) {
+            const char* base = _buf.data() + _pos;
+            for (const size_t n = avail(); i < n; ++i) {
+                const char c = base[i];
+                if (quote) {
+                    if (c == quote) quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '>') {
+                    return i;
+                }
+            }
+            if (!fill_more()) return npos;
+        }
+    }
+
+    Event read_start_tag() {
+        const size_t len = find_tag_end();
+        if (len == npos) {
+            fail("unterminated start tag");
+            return _event;
+        }
+        const size_t off = _pos;
+        char* tag = _buf.data() + off;
+        _pos += len + 1;
+
+        size_t end = len;
+        const bool empty = tag[end - 1] == '/';
+        if (empty) --end;
+
+        size_t i = 1;
+        while (i < end && !is_space(tag[i])) ++i;
+        if (i == 1) {
+            fail("missing element name");
+            return _event;
+        }
+        _nameOff = off + 1;
+        _nameLen = i - 1;
+
+        for (;;) {
+            while (i < end && is_space(tag[i])) ++i;
+            if (i >= end) break;
+            const size_t nameStart = i;
+            while (i < end && tag[i] != '=' && !is_space(tag[i])) ++i;
+            const size_t nameLen = i - nameStart;
+            while (i < end && is_space(tag[i])) ++i;
+            if (nameLen == 0 || i >= end || tag[i] != '=') {
+                fail("malformed attribute");
+                return _event;
+            }
+            ++i;
+            while (i < end && is_space(tag[i])) ++i;
+            if (i >= end || (tag[i] != '"' && tag[i] != '\'')) {
+                fail("malformed attribute");
+                return _event;
+            }
+            const char quote = tag[i++];
+            const size_t valueStart = i;
+            while (i < end && tag[i] != quote) ++i;
+            if (i >= end) {
+                fail("malformed attribute");
+                return _event;
+            }
+            const size_t valueLen = decode(tag + valueStart, tag + i);
+            _attrs.push_back({off + nameStart, nameLen, off + valueStart, valueLen});
+            ++i;
+        }
+
+        if (_stack.size() <= static_cast<size_t>(_depth)) _stack.emplace_back();
+        _stack[_depth].assign(tag + 1, _nameLen);
+        ++_depth;
+        _pendingEnd = empty;
+        return _event = StartElement;
+    }
+
+    Event read_end_tag() {
+        const size_t len = find(">", 2);
+        if (len == npos) {
+            fail("unterminated end tag");
+            return _event;
+        }
+        const size_t off = _pos;
+        _pos += len + 1;
+        size_t end = len;
+        while (end > 2 && is_space(_buf[off + end - 1])) --end;
+        _nameOff = off + 2;
+        _nameLen = end - 2;
+        if (_depth == 0 || _stack[_depth - 1] != name()) {
+            fail("mismatched end tag </" + std::string(name()) + ">");
+            return _event;
+        }
+        --_depth;
+        return _event = EndElement;
+    }
+
+    static char* put_utf8(char* out, unsigned long cp) {
+        if (cp < 0x80) {
+            *out++ = static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (cp >> 6));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (cp >> 12));
+            *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            *out++ = static_cast<char>(0xF0 | (cp >> 18));
+            *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        return out;
+    }
+
+    // Resolves entity and character references in place (the result is never
+    // longer than the input). Unknown entities are kept verbatim.
+    static size_t decode(char* first, char* last) {
+        char* p = static_cast<char*>(std::memchr(first, '&', last - first));
+        if (!p) return last - first;
+        char* out = p;
+        while (p < last) {
+            if (*p != '&') {
+                *out++ = *p++;
+                continue;
+            }
+            char* semi = static_cast<char*>(std::memchr(p, ';', std::min<size_t>(last - p, 12)));
+            if (!semi) {
+                *out++ = *p++;
+                continue;
+            }
+            const std::string_view ent(p + 1, semi - p - 1);
+            char ch = 0;
+            if (ent == "lt") ch = '<';
+            else if (ent == "gt") ch = '>';
+            else if (ent == "amp") ch = '&';
+            else if (ent == "quot") ch = '"';
+            else if (ent == "apos") ch = '\'';
+            if (ch) {
+                *out++ = ch;
+                p = semi + 1;
+                continue;
+            }
+            if (ent.size() > 1 && ent[0] == '#') {
+                const bool hex = ent[1] == 'x' || ent[1] == 'X';
+                const char* digits = p + (hex ? 3 : 2);
+                unsigned long cp = 0;
+                auto res = std::from_chars(digits, semi, cp, hex ? 16 : 10);
+                if (digits != semi && res.ec == std::errc() && res.ptr == semi && cp > 0 && cp <= 0x10FFFF) {
+                    out = put_utf8(out, cp);
+                    p = semi + 1;
+                    continue;
+                }
+            }
+            *out++ = *p++;
+        }
+        return out - first;
+    }
+
+    FILE* _file = nullptr;
+    const char* _data = nullptr;
+    size_t _dataSize = 0;
+    size_t _dataPos = 0;
+
+    std::vector<char> _buf;
+    size_t _pos = 0;
+    size_t _end = 0;
+    bool _eof = false;
+    bool _started = false;
+    bool _pinned = false;
+    size_t _pin = 0;
+
+    Event _event = None;
+    std::string _error;
+    int _depth = 0;
+    bool _pendingEnd = false;
+    size_t _nameOff = 0, _nameLen = 0;
+    size_t _textOff = 0, _textLen = 0;
+    std::vector<Attribute> _attrs;
+    std::vector<std::string> _stack;
+    std::string _scratch;
+};
+
+} // namespace OSerialize
+
+#endif // O_SERIALIZE_XML_READER_H
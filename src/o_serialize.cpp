@@ -1,7 +1,55 @@
 #include <iostream>
+#include "o_serialize/stats.h"
+
+#ifdef O_SERIALIZE_ENABLE_STATS
+#include <cstdlib>
+#include <new>
+#endif
 
 namespace OSerialize {
     void init() {
         // Placeholder
     }
+
+#ifdef O_SERIALIZE_ENABLE_STATS
+    namespace {
+        // Constant-initialized, so it is safe to touch from operator new at any time
+        thread_local Stats::HeapCounters heapCounters = {0, 0};
+    }
+
+    Stats::HeapCounters& Stats::heap() {
+        return heapCounters;
+    }
+#endif
+}
+
+#ifdef O_SERIALIZE_ENABLE_STATS
+// Counting replacements of the global allocation functions. Over-aligned
+// allocations keep the default implementation and are not counted.
+namespace {
+    void* counted_alloc(std::size_t size) {
+        OSerialize::Stats::HeapCounters& counters = OSerialize::Stats::heap();
+        ++counters.allocations;
+        counters.bytes += size;
+        return std::malloc(size ? size : 1);
+    }
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = counted_alloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = counted_alloc(size)) return p;
+    throw std::bad_alloc();
 }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
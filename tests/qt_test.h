@@ -9,6 +9,10 @@
 #include <QDate>
 #include <QDateTime>
 #include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
 #include <QLinkedList>
 #include <QList>
 #include <QMap>
@@ -27,6 +31,7 @@
 #include <QTime>
 #include <QVariant>
 #include <QVector>
+#include <cmath>
 
 using namespace OSerialize;
 
@@ -253,6 +258,94 @@ void test_all_qt_types()
     std::cout << "AllQtTypes struct passed." << std::endl;
 }
 
+struct QJsonItem
+{
+    int     count = 0;
+    QString label;
+
+    bool operator==(const QJsonItem &other) const { return count == other.count && label == other.label; }
+};
+
+struct QJsonTypes
+{
+    qint64                   id = 0;
+    double                   whole = 0;
+    double                   negativeZero = 0;
+    double                   ratio = 0;
+    QString                  name;
+    QStringList              tags;
+    QVector<QVector<int>>    grid;
+    QList<QJsonItem>         items;
+    QMap<QString, QJsonItem> byName;
+    QDateTime                when;
+    QPoint                   pt;
+    QRect                    rect;
+
+    bool operator==(const QJsonTypes &other) const
+    {
+        return id == other.id && whole == other.whole && negativeZero == other.negativeZero && ratio == other.ratio
+               && name == other.name && tags == other.tags && grid == other.grid && items == other.items
+               && byName == other.byName && when == other.when && pt == other.pt && rect == other.rect;
+    }
+};
+} // namespace QtTest
+
+O_SERIALIZE_STRUCT(QtTest::QJsonItem, count, label);
+O_SERIALIZE_STRUCT(QtTest::QJsonTypes, id, whole, negativeZero, ratio, name, tags, grid, items, byName, when, pt, rect);
+
+namespace QtTest {
+void test_qjson()
+{
+    std::cout << "Testing QJsonValue / QCborValue conversion..." << std::endl;
+    QJsonTypes original;
+    original.id = 1234567;
+    original.whole = 3.0;
+    original.negativeZero = -0.0;
+    original.ratio = 0.1;
+    original.name = "Qt JSON";
+    original.tags = QStringList({"a", "b"});
+    original.grid = {{1, 2}, {}, {3}};
+    original.items = {{1, "one"}, {2, "two"}};
+    original.byName.insert("x", {3, "three"});
+    original.when = QDateTime(QDate(2024, 2, 29), QTime(23, 59, 58));
+    original.pt = QPoint(-4, 9);
+    original.rect = QRect(1, 2, 30, 40);
+
+    // 不经过文本的往返；整数值的 double 仍是 double，-0.0 保留符号
+    const QJsonValue json = JSON::to_qjson(original);
+    assert(json.isObject());
+    assert(json.toObject().value("grid").toArray().at(0).toArray().at(1).toInt() == 2);
+    assert(json.toObject().value("items").toArray().at(1).toObject().value("label").toString() == "two");
+    QJsonTypes fromJson;
+    JSON::from_qjson(json, fromJson);
+    assert(fromJson == original);
+    assert(std::signbit(fromJson.negativeZero));
+
+    QJsonTypes fromDocument;
+    JSON::from_qjson(QJsonDocument(json.toObject()), fromDocument);
+    assert(fromDocument == original);
+
+    // QJsonValue 中整数值的 double 可解码到整数成员；缺少的成员保持原值
+    QJsonObject numbers;
+    numbers.insert("id", 42.0);
+    numbers.insert("whole", 7);
+    QJsonTypes fromNumbers;
+    fromNumbers.name = "kept";
+    JSON::from_qjson(numbers, fromNumbers);
+    assert(fromNumbers.id == 42 && fromNumbers.whole == 7.0 && fromNumbers.name == "kept");
+
+    // 顶层数组
+    QVector<QVector<int>> grid;
+    JSON::from_qjson(JSON::to_qjson(original.grid), grid);
+    assert(grid == original.grid);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QJsonTypes fromCbor;
+    JSON::from_qcbor(JSON::to_qcbor(original), fromCbor);
+    assert(fromCbor == original);
+#endif
+}
+
 void run_all()
 {
     test_qstring();
@@ -272,6 +365,7 @@ void run_all()
     test_qvariant();
     test_qsharedpointer();
     test_all_qt_types();
+    test_qjson();
 }
 } // namespace QtTest
 
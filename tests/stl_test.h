@@ -1,15 +1,24 @@
 #ifndef STL_TEST_H
 #define STL_TEST_H
 
+#include "o_serialize/diff.h"
+#include "o_serialize/generate.h"
+#include "o_serialize/ini.h"
 #include "o_serialize/json.h"
+#include "o_serialize/snapshot.h"
+#include "o_serialize/watch.h"
+#include "o_serialize/xml.h"
 #include <cassert>
+#include <cctype>
 #include <deque>
 #include <iostream>
 #include <list>
 #include <map>
 #include <memory>
+#include <random>
 #include <set>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -39,6 +48,36 @@ void test_double()
     assert(abs(original - parsed) < 0.0001);
 }
 
+void test_float()
+{
+    std::cout << "Testing float..." << std::endl;
+    float       original = 1.1f;
+    std::string json = JSON::obj_to_string(original);
+    float       parsed = JSON::string_to_obj<float>(json);
+    // 最短往返表示，不应输出为 1.100000023841858
+    assert(json == "1.1");
+    assert(original == parsed);
+    assert(JSON::obj_to_string(std::vector<float>{0.1f, 2.5f, -3.0f}) == "[0.1,2.5,-3.0]");
+}
+
+void test_max_decimal_places()
+{
+    std::cout << "Testing maxDecimalPlaces..." << std::endl;
+    const double values[] = {1.23456789e-05, 0.1, 123.456, 1e-7, 1.2345e-7, 1e30, 0.0, -0.0, 1.0, -2.5, 3.14159265358979, 1e21, 1e22};
+    for (double val : values) {
+        for (int places : {1, 2, 3, 6, 10}) {
+            rapidjson::StringBuffer                    buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            writer.SetMaxDecimalPlaces(places);
+            writer.Double(val);
+            char buf[Number::kBufferSize];
+            assert(std::string(buf, Number::format(buf, buf + sizeof(buf), val, places)) == buffer.GetString());
+        }
+    }
+    char buf[Number::kBufferSize];
+    assert(std::string(buf, Number::format(buf, buf + sizeof(buf), 1.23456789e-05, 6)) == "0.000012");
+}
+
 void test_string()
 {
     std::cout << "Testing std::string..." << std::endl;
@@ -182,6 +221,636 @@ void test_all_stl_types()
     assert(*original_qptr.get() == *parsed_qptr.get());
 }
 
+struct Inner
+{
+    int         a = 0;
+    std::string b;
+
+    bool operator==(const Inner &other) const { return a == other.a && b == other.b; }
+};
+
+struct Outer
+{
+    int                        id = 0;
+    std::string                name;
+    double                     score = 0;
+    Inner                      inner;
+    std::vector<int>           tags;
+    std::map<std::string, int> counts;
+
+    bool operator==(const Outer &other) const
+    {
+        return id == other.id && name == other.name && score == other.score && inner == other.inner && tags == other.tags
+               && counts == other.counts;
+    }
+};
+
+Outer make_outer()
+{
+    Outer outer;
+    outer.id = 42;
+    outer.name = "a \"quoted\" <name> & more";
+    outer.score = 0.25;
+    outer.inner = {7, "seven"};
+    outer.tags = {3, 1, 2};
+    outer.counts = {{"x", 1}, {"y", 2}};
+    return outer;
+}
+} // namespace StlTest
+
+O_SERIALIZE_STRUCT(StlTest::Inner, a, b);
+O_SERIALIZE_STRUCT(StlTest::Outer, id, name, score, inner, tags, counts);
+
+
+namespace StlTest {
+void test_xml_round_trip()
+{
+    std::cout << "Testing XML round trip..." << std::endl;
+    const Outer original = make_outer();
+
+    // 嵌套结构体、map、容器与需要转义的文本，Pretty 与 Compact 两种排版
+    Outer pretty;
+    assert(XML::try_parse(XML::stringify(original), pretty));
+    assert(pretty == original);
+    Outer compact;
+    assert(XML::try_parse(XML::stringify(original, "config", WriteOptions::compact()), compact, "config"));
+    assert(compact == original);
+
+    // 属性模式：标量成员写为属性，读取时两种写法都接受
+    WriteOptions attributes = WriteOptions::compact();
+    attributes.xmlAttributes = true;
+    const std::string xml = XML::stringify(original, "root", attributes);
+    assert(xml.find("id=\"42\"") != std::string::npos);
+    Outer fromAttributes;
+    assert(XML::try_parse(xml, fromAttributes));
+    assert(fromAttributes == original);
+    Outer mixed;
+    assert(XML::try_parse("<root id=\"5\" name=\"n\"><inner a=\"1\"><b>x</b></inner><score>0.5</score></root>", mixed));
+    assert(mixed.id == 5 && mixed.name == "n" && mixed.inner == (Inner{1, "x"}) && mixed.score == 0.5);
+
+    // 从文件流式读取 <item> 序列
+    std::vector<Outer> list = {original, original};
+    list[1].id = 43;
+    const std::string filepath = "test_output.xml";
+    assert(XML::obj_to_file(list, filepath, "list"));
+    std::vector<Outer> streamed;
+    FILE *file = std::fopen(filepath.c_str(), "rb");
+    assert(XML::for_each_item<Outer>(file, "list", [&](Outer &&item) { streamed.push_back(std::move(item)); }));
+    std::fclose(file);
+    assert(streamed == list);
+}
+
+void test_xml_malformed()
+{
+    std::cout << "Testing malformed XML..." << std::endl;
+    Outer obj;
+    assert(!XML::try_parse("<root><id>1</id>", obj));                  // 未闭合
+    assert(!XML::try_parse("<root><id>1</ids></root>", obj));          // 标签不匹配
+    assert(!XML::try_parse("<other><id>1</id></other>", obj));         // 根元素名不对
+    assert(!XML::try_parse("<root id=\"1><name>a</name></root>", obj)); // 属性未闭合
+    assert(!XML::try_parse("", obj));
+
+    // 无法转换的值返回 false，其余成员照常读取
+    Outer partial;
+    assert(!XML::try_parse("<root><id>abc</id><name>kept</name></root>", partial));
+    assert(partial.id == 0 && partial.name == "kept");
+}
+
+struct Flat
+{
+    int              id = 0;
+    std::string      name;
+    double           score = 0;
+    bool             enabled = false;
+    std::vector<int> tags;
+
+    bool operator==(const Flat &other) const
+    {
+        return id == other.id && name == other.name && score == other.score && enabled == other.enabled
+               && tags == other.tags;
+    }
+};
+} // namespace StlTest
+
+O_SERIALIZE_STRUCT(StlTest::Flat, id, name, score, enabled, tags);
+
+namespace StlTest {
+void test_ini_round_trip()
+{
+    std::cout << "Testing INI round trip..." << std::endl;
+    const Flat original = {7, "plain name", 0.25, true, {3, 1, 2}};
+    Flat       parsed;
+    assert(INI::try_parse(INI::stringify(original), parsed));
+    assert(parsed == original);
+    Flat named;
+    assert(INI::try_parse(INI::stringify(original, "app"), named, "app"));
+    assert(named == original);
+
+    // 注释、空白与逗号分隔的列表
+    Flat handWritten;
+    assert(INI::try_parse("; comment\n[other]\nid=1\n[default]\n  id = 7 \nname=x\ntags=10, 20\n", handWritten));
+    assert(handWritten.id == 7 && handWritten.name == "x");
+    assert((handWritten.tags == std::vector<int>{10, 20}));
+    std::vector<int> items;
+    assert(INI::try_parse(INI::stringify(std::vector<int>{10, 20, 40}), items));
+    assert((items == std::vector<int>{10, 20, 40}));
+
+    // 乱序与不连续的 itemN 键
+    assert(INI::try_parse("[default]\nitem1=20\nitem0=10\nitem3=40\n", items));
+    assert((items == std::vector<int>{10, 20, 40}));
+
+    // 嵌套结构体与 map 写为 [default.inner]、[default.counts] 子节
+    Outer outer = make_outer();
+    outer.name = "plain name";
+    Outer nested;
+    assert(INI::try_parse(INI::stringify(outer), nested));
+    assert(nested == outer);
+    std::vector<Outer> list = {outer, outer};
+    list[1].inner.a = 8;
+    std::vector<Outer> parsedList;
+    assert(INI::try_parse(INI::stringify(list), parsedList));
+    assert(parsedList == list);
+    Outer handNested;
+    assert(INI::try_parse("[default]\nid=7\n[default.inner]\na=3\n", handNested));
+    assert(handNested.id == 7 && handNested.inner.a == 3);
+    Flat compact;
+    assert(INI::try_parse(INI::stringify(original, "app", WriteOptions::compact()), compact, "app"));
+    assert(compact == original);
+}
+
+void test_ini_malformed()
+{
+    std::cout << "Testing malformed INI..." << std::endl;
+    Flat obj;
+    assert(!INI::try_parse("[other]\nid=1\n", obj));
+    assert(!INI::try_parse("", obj));
+
+    // 无法转换的值返回 false，其余键照常读取；不成形的行被忽略
+    Flat partial;
+    assert(!INI::try_parse("[default]\nid=abc\nname=kept\nnot a key\n[broken\nscore=1.5\n", partial));
+    assert(partial.id == 0 && partial.name == "kept" && partial.score == 1.5);
+}
+
+void test_diff()
+{
+    std::cout << "Testing Diff..." << std::endl;
+    const Outer before = make_outer();
+    Outer       after = before;
+    assert(Diff::equal(before, after));
+    assert(Diff::changed_fields(before, after).empty());
+
+    after.name = "renamed";
+    after.inner.a = 8;
+    after.counts["z"] = 3;
+    assert(!Diff::equal(before, after));
+    assert((Diff::changed_fields(before, after) == std::vector<std::string>{"name", "inner.a", "counts"}));
+
+    // apply 只移动有变化的成员
+    Outer                    live = before;
+    std::vector<std::string> applied;
+    Diff::apply(live, Outer(after), [&](const std::string &path) { applied.push_back(path); });
+    assert(live == after);
+    assert((applied == std::vector<std::string>{"name", "inner.a", "counts"}));
+
+    // 智能指针比较指向的对象
+    std::shared_ptr<int> a = std::make_shared<int>(1), b = std::make_shared<int>(1);
+    assert(Diff::equal(a, b));
+    *b = 2;
+    assert(!Diff::equal(a, b));
+}
+
+#ifdef __linux__
+void test_config_watcher()
+{
+    std::cout << "Testing ConfigWatcher..." << std::endl;
+    char dir[] = "/tmp/o_serialize_watch_XXXXXX";
+    assert(::mkdtemp(dir));
+    const std::string path = std::string(dir) + "/config.json";
+    const Outer       original = make_outer();
+    assert(JSON::obj_to_file(original, path));
+
+    ConfigWatcher<Outer> watcher(path, ConfigWatcher<Outer>::json());
+    assert(watcher.start());
+    assert(watcher.current() == original);
+    std::vector<std::string> all, inner;
+    watcher.subscribe([&](const Outer &, const std::vector<std::string> &changed) { all = changed; });
+    watcher.subscribe("inner", [&](const Outer &, const std::vector<std::string> &changed) { inner = changed; });
+
+    // 原地改写：只应用有变化的成员，未变的成员（tags 的存储）保持不动
+    const int *tags = watcher.current().tags.data();
+    Outer      next = original;
+    next.name = "renamed";
+    next.inner.a = 8;
+    assert(JSON::obj_to_file(next, path));
+    assert(watcher.poll(1000));
+    assert(watcher.current() == next);
+    assert(watcher.current().tags.data() == tags);
+    assert((all == std::vector<std::string>{"name", "inner.a"}));
+    assert((inner == std::vector<std::string>{"inner.a"}));
+
+    // 内容相同的写入与无法解析的文件都不改变当前对象，也不通知
+    all.clear();
+    inner.clear();
+    assert(JSON::obj_to_file(next, path));
+    assert(!watcher.poll(1000));
+    FILE *file = std::fopen(path.c_str(), "wb");
+    std::fputs("{\"id\": ", file);
+    std::fclose(file);
+    assert(!watcher.poll(1000));
+    assert(watcher.current() == next && all.empty());
+
+    // 编辑器式的保存：写临时文件后 rename 覆盖
+    next.score = 0.5;
+    const std::string temp = path + ".tmp";
+    assert(JSON::obj_to_file(next, temp));
+    assert(std::rename(temp.c_str(), path.c_str()) == 0);
+    assert(watcher.poll(1000));
+    assert(watcher.current() == next);
+    assert((all == std::vector<std::string>{"score"}) && inner.empty());
+
+    std::remove(path.c_str());
+    ::rmdir(dir);
+}
+#endif
+
+void test_snapshot()
+{
+    std::cout << "Testing Snapshot..." << std::endl;
+    Snapshot<Outer> snapshot(make_outer());
+    {
+        auto held = snapshot.read();
+        assert(held->id == 42);
+
+        Outer next = make_outer();
+        next.id = 43;
+        snapshot.publish(next);
+        snapshot.reclaim();
+
+        // 发布前取得的 Reader 仍指向旧版本，直到它被释放
+        assert(held->id == 42 && held->name == make_outer().name);
+        assert(snapshot.read()->id == 43);
+    }
+    snapshot.reclaim();
+    assert(snapshot.read()->id == 43);
+
+    // 读者线程持续读取时发布新版本；短生命周期的 Snapshot 不会在线程里留下记录
+    std::atomic<bool> stop{false};
+    std::thread       reader([&] {
+        while (!stop.load()) {
+            auto current = snapshot.read();
+            assert(current->id >= 43 && current->inner == make_outer().inner);
+            Snapshot<int> temporary(1);
+            assert(*temporary.read() == 1);
+        }
+    });
+    for (int i = 0; i < 1000; ++i) {
+        Outer next = make_outer();
+        next.id = 44 + i;
+        snapshot.publish(next);
+    }
+    stop.store(true);
+    reader.join();
+    assert(snapshot.read()->id == 1043);
+}
+
+struct Node
+{
+    int                   value = 0;
+    std::string           label;
+    std::vector<Node>     children;
+    std::shared_ptr<Node> next;
+};
+} // namespace StlTest
+
+O_SERIALIZE_STRUCT(StlTest::Node, value, label, children, next);
+
+namespace StlTest {
+// depth 为 node 自身被填充时的深度，成员在 depth + 1 层
+void check_generated(const Node &node, int depth, const GenerateShape &shape)
+{
+    assert(node.label.size() >= shape.minString && node.label.size() <= shape.maxString);
+    assert(node.label.find_first_not_of(shape.alphabet) == std::string::npos);
+    if (depth + 1 >= shape.maxDepth) {
+        assert(node.children.empty() && !node.next);
+        return;
+    }
+    assert(node.children.size() >= shape.minItems && node.children.size() <= shape.maxItems);
+    assert(node.next);
+    for (const Node &child : node.children) check_generated(child, depth + 2, shape);
+    check_generated(*node.next, depth + 2, shape);
+}
+
+void test_generate()
+{
+    std::cout << "Testing Generate..." << std::endl;
+    GenerateShape shape;
+    shape.minItems = 1;
+    shape.maxItems = 3;
+    shape.minString = 2;
+    shape.maxString = 5;
+    shape.maxDepth = 5;
+    shape.nullChance = 0;
+    std::mt19937_64 rng(42);
+
+    // 自引用的容器与指针在 maxDepth 处停止
+    for (int round = 0; round < 20; ++round) check_generated(Generate<Node>(rng, shape), 0, shape);
+    const Node node = Generate<Node>(rng, shape);
+    assert(Diff::equal(node, JSON::string_to_obj<Node>(JSON::obj_to_string(node))));
+
+    // map 的键以字母开头，其余部分仍按 minString / maxString
+    const auto counts = Generate<std::map<std::string, int>>(rng, shape);
+    assert(!counts.empty());
+    for (const auto &pair : counts) {
+        assert(std::isalpha(static_cast<unsigned char>(pair.first[0])));
+        assert(pair.first.size() >= shape.minString + 1 && pair.first.size() <= shape.maxString + 1);
+    }
+
+    // maxDepth 为 0 时顶层容器也为空
+    shape.maxDepth = 0;
+    assert(Generate<std::vector<Node>>(rng, shape).empty());
+}
+
+void test_lazy_view()
+{
+    std::cout << "Testing LazyView..." << std::endl;
+    const Outer       original = make_outer();
+    const std::string json = JSON::obj_to_string(original, WriteOptions::pretty());
+
+    JSON::LazyView<Outer> view(json);
+    assert(view.is_valid());
+    assert(view.has(&Outer::tags) && view.has(&Outer::inner));
+    assert(view.get(&Outer::id) == 42);
+    assert(view.get(&Outer::inner) == original.inner);
+    assert(view.get(&Outer::tags) == original.tags);
+    assert(view.obj() == JSON::string_to_obj<Outer>(json));
+
+    // 缺少的成员返回默认值；成员顺序与空白不影响结果
+    JSON::LazyView<Outer> partial(" { \"counts\" : {\"k\": 1}, \"unknown\": [1, {\"id\": 9}], \"id\": 5 } ");
+    assert(partial.is_valid());
+    assert(!partial.has(&Outer::name) && partial.get(&Outer::name).empty());
+    assert(partial.get(&Outer::id) == 5);
+    assert((partial.get(&Outer::counts) == std::map<std::string, int>{{"k", 1}}));
+
+    assert(!JSON::LazyView<Outer>("{\"id\": ").is_valid());
+    assert(!JSON::LazyView<Outer>("[1, 2]").is_valid());
+}
+
+void test_extract()
+{
+    std::cout << "Testing JSON Pointer extract..." << std::endl;
+    const std::string json = R"({"a/b": 1, "m~n": "tilde", "list": [10, {"deep": [true, "x"]}, 30],
+                                 "inner": {"a": 7, "b": "seven"}, "a/b2": 2})";
+
+    // ~1 表示 '/'，~0 表示 '~'
+    assert(JSON::extract<int>(json, "/a~1b") == 1);
+    assert(JSON::extract<std::string>(json, "/m~0n") == "tilde");
+    // 数组下标与嵌套
+    assert(JSON::extract<int>(json, "/list/0") == 10);
+    assert(JSON::extract<int>(json, "/list/2") == 30);
+    assert(JSON::extract<std::string>(json, "/list/1/deep/1") == "x");
+    assert(JSON::extract<Inner>(json, "/inner") == (Inner{7, "seven"}));
+    assert((JSON::extract<std::vector<int>>(R"({"v": [1, 2, 3]})", "/v") == std::vector<int>{1, 2, 3}));
+
+    // 多个目标一次扫描；缺失的路径保持原值，不计入返回值
+    int         first = -1, missing = -1, outOfRange = -1;
+    bool        flag = false;
+    std::string name;
+    assert(JSON::extract(json, JSON::at("/list/1/deep/0", flag), JSON::at("/inner/b", name), JSON::at("/nope", missing),
+                         JSON::at("/list/9", outOfRange), JSON::at("/a~1b", first))
+           == 3);
+    assert(flag && name == "seven" && first == 1 && missing == -1 && outOfRange == -1);
+
+    // 所有路径都找到后停止，之后的文本不再读取
+    assert(JSON::extract<int>(R"({"id": 5, "rest": [ this is not json)", "/id") == 5);
+    assert(JSON::extract<int>("not json", "/id") == 0);
+}
+
+void test_value_and_sax()
+{
+    std::cout << "Testing value and SAX conversion..." << std::endl;
+    const Outer       original = make_outer();
+    const std::string json = JSON::obj_to_string(original);
+
+    // 调用方已有的 Document；json 中没有的成员保持原值
+    JSON::Document doc;
+    doc.Parse(json.c_str());
+    Outer fromValue;
+    JSON::from_value(doc, fromValue);
+    assert(fromValue == original);
+    JSON::Document partial;
+    partial.Parse("{\"id\": 5}");
+    JSON::from_value(partial, fromValue);
+    assert(fromValue.id == 5 && fromValue.name == original.name);
+
+    // to_value 的结果自带字符串，包括 to_json 只引用的大字符串，source 改写或销毁后仍有效
+    JSON::Document target(rapidjson::kObjectType);
+    {
+        Outer source = make_outer();
+        source.name.assign(5000, 'n');
+        target.AddMember("outer", JSON::to_value(source, target.GetAllocator()), target.GetAllocator());
+        source.name.assign(5000, 'x');
+    }
+    Outer fromTarget;
+    JSON::from_value(target["outer"], fromTarget);
+    assert(fromTarget.name == std::string(5000, 'n'));
+
+    // from_sax：Reader 或另一个 Value 的 Accept 作为事件源；流不完整时返回 false，obj 不变
+    rapidjson::Reader       reader;
+    rapidjson::StringStream stream(json.c_str());
+    Outer                   fromSax;
+    assert(JSON::from_sax([&](auto &handler) { return reader.Parse(stream, handler); }, fromSax));
+    assert(fromSax == original);
+    Outer fromAccept;
+    assert(JSON::from_sax([&](auto &handler) { return doc.Accept(handler); }, fromAccept));
+    assert(fromAccept == original);
+    const std::string       truncated = json.substr(0, json.size() / 2);
+    rapidjson::StringStream truncatedStream(truncated.c_str());
+    Outer                   untouched;
+    assert(!JSON::from_sax([&](auto &handler) { return reader.Parse(truncatedStream, handler); }, untouched));
+    assert(untouched == Outer());
+
+    // to_sax 交给调用方的 Writer，输出与 obj_to_string 逐字节相同
+    rapidjson::StringBuffer                    buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    assert(JSON::to_sax(original, writer));
+    assert(std::string(buffer.GetString(), buffer.GetSize()) == json);
+}
+
+void test_field_mask()
+{
+    std::cout << "Testing FieldMask..." << std::endl;
+    const Outer    original = make_outer();
+    FieldMask<Outer> mask(&Outer::id, &Outer::inner);
+    mask.add("counts");
+    mask.add("no_such_member");
+    assert(mask.contains(0) && !mask.contains(1) && mask.contains(3) && mask.contains(5));
+
+    Outer expected;
+    expected.id = original.id;
+    expected.inner = original.inner;
+    expected.counts = original.counts;
+
+    Outer fromJson = JSON::string_to_obj<Outer>(JSON::obj_to_string(original), mask);
+    assert(fromJson == expected);
+
+    Outer fromXml = XML::parse<Outer>(XML::stringify(original), mask);
+    assert(fromXml == expected);
+
+    // 空的 FieldMask 不读取任何成员
+    assert(JSON::string_to_obj<Outer>(JSON::obj_to_string(original), FieldMask<Outer>()) == Outer());
+}
+
+void test_xml_non_struct_root()
+{
+    std::cout << "Testing XML non-struct roots..." << std::endl;
+    std::vector<int> items;
+    assert(XML::try_parse("<root><item>1</item><item>2</item></root>", items));
+    assert((items == std::vector<int>{1, 2}));
+    assert((XML::parse<std::vector<int>>(XML::stringify(items, "items"), "items") == items));
+
+    std::map<std::string, int> map = {{"one", 1}, {"two", 2}};
+    std::map<std::string, int> parsedMap;
+    assert(XML::try_parse(XML::stringify(map), parsedMap));
+    assert(parsedMap == map);
+
+    int scalar = 0;
+    assert(XML::try_parse("<root>17</root>", scalar));
+    assert(scalar == 17);
+}
+
+void test_sinks()
+{
+    std::cout << "Testing output sinks..." << std::endl;
+    const Outer       original = make_outer();
+    const std::string expected = JSON::obj_to_string(original);
+
+    // 复用的字符串：内容被替换
+    std::string out = "stale contents";
+    JSON::obj_to_string(original, out);
+    assert(out == expected);
+
+    // 大字符串：rapidjson 按每字符 6 字节预留，容量不应随之膨胀
+    std::string big(4u << 20, 'x');
+    JSON::obj_to_string(big, out);
+    assert(out.size() == big.size() + 2);
+    assert(out.capacity() <= 2 * out.size() + StringSink::kGrowStep);
+
+    // 固定缓冲区：不够时丢弃超出部分，返回所需长度
+    std::vector<char> buffer(expected.size());
+    assert(JSON::obj_to_buffer(original, buffer.data(), buffer.size()) == expected.size());
+    assert(std::string(buffer.data(), buffer.size()) == expected);
+    char small[8];
+    assert(JSON::obj_to_buffer(original, small, sizeof(small)) == expected.size());
+    assert(std::string(small, sizeof(small)) == expected.substr(0, sizeof(small)));
+
+    BufferSink sink(small, sizeof(small));
+    JSON::obj_to_sink(original, sink);
+    assert(sink.overflowed() && sink.size() == sizeof(small) && sink.required() == expected.size());
+
+#if defined(__unix__) || defined(__APPLE__)
+    // 分块输出拼接后与 obj_to_string 一致，含按引用追加的大字符串与跨块的 token
+    std::vector<std::string> values = {std::string(IovecSink::kBlockSize + 17, 'y'), "short", std::string(5000, 'z')};
+    IovecSink gather;
+    for (int round = 0; round < 2; ++round) {
+        gather.reset();
+        JSON::obj_to_iovec(values, gather);
+        std::string joined;
+        for (const auto &segment : gather.iov()) joined.append(static_cast<const char *>(segment.iov_base), segment.iov_len);
+        assert(joined == JSON::obj_to_string(values));
+        assert(gather.size() == joined.size());
+    }
+
+    // 含 '\0' 的二进制内容按长度写出，不在第一个 '\0' 处截断
+    std::string blob(5000, 'b');
+    blob[10] = '\0';
+    gather.reset();
+    JSON::obj_to_iovec(blob, gather);
+    std::string joined;
+    for (const auto &segment : gather.iov()) joined.append(static_cast<const char *>(segment.iov_base), segment.iov_len);
+    assert(joined == JSON::obj_to_string(blob));
+    assert(JSON::string_to_obj<std::string>(joined) == blob);
+#endif
+}
+
+void test_size_hint()
+{
+    std::cout << "Testing size_hint..." << std::endl;
+    const Outer outer = make_outer();
+    assert(JSON::size_hint(outer) == JSON::obj_to_string(outer).size());
+    std::vector<double> doubles = {0.1, -2.5, 1e30, 1.23456789e-05, 3.0, 0.0};
+    assert(JSON::size_hint(doubles) == JSON::obj_to_string(doubles).size());
+    std::vector<float> floats = {1.1f, 0.1f, -3.0f};
+    assert(JSON::size_hint(floats) == JSON::obj_to_string(floats).size());
+    std::pair<int, std::string> pair = {-12, "tab\there"};
+    assert(JSON::size_hint(pair) == JSON::obj_to_string(pair).size());
+    AllStlTypes all;
+    all.i = 1;
+    all.d = 99.9;
+    all.map = {{"k", 1}};
+    all.tuple = {2, 0.5};
+    all.ptr = std::make_shared<int>(3);
+    assert(JSON::size_hint(all) == JSON::obj_to_string(all).size());
+}
+
+void test_ini_dotted_map_keys()
+{
+    std::cout << "Testing INI map keys containing '.'..." << std::endl;
+    std::map<std::string, Inner> original = {{"x.y", {1, "one"}}, {"50%", {2, "two"}}, {"plain", {3, "three"}}};
+    std::string                  ini = INI::stringify(original);
+    assert(ini.find("[default.x.y]") == std::string::npos);
+
+    std::map<std::string, Inner> parsed;
+    assert(INI::try_parse(ini, parsed));
+    assert(parsed == original);
+}
+
+void test_stats()
+{
+    std::cout << "Testing Stats..." << std::endl;
+    Outer big = make_outer();
+    big.tags.assign(50000, 7);
+    Stats::reset();
+
+#ifdef O_SERIALIZE_ENABLE_STATS
+    // obj_to_string 内部嵌套的入口并入这一次调用
+    const std::string json = JSON::obj_to_string(big);
+    const Stats       write = Stats::last();
+    assert(write.calls == 1 && write.outputBytes == json.size());
+    assert(write.allocations > 0 && write.jsonPoolBytes > 0);
+    // rapidjson 内存池与 StringBuffer 的 malloc 也计入
+    assert(write.allocatedBytes >= write.jsonPoolBytes + write.outputBytes);
+
+    const Outer parsed = JSON::string_to_obj<Outer>(json);
+    assert(parsed == big);
+    const Stats read = Stats::last();
+    assert(read.calls == 1 && read.allocations > 0 && read.allocatedBytes >= read.jsonPoolBytes);
+
+    // accumulated()：次数与字节相加，峰值取最大
+    const Stats total = Stats::accumulated();
+    assert(total.calls == 2);
+    assert(total.allocations == write.allocations + read.allocations);
+    assert(total.allocatedBytes == write.allocatedBytes + read.allocatedBytes);
+    assert(total.jsonPoolBytes == std::max(write.jsonPoolBytes, read.jsonPoolBytes));
+    assert(total.outputBytes == write.outputBytes);
+
+    // 调用方的 Scope 包住的多次调用记为一次
+    std::string xml;
+    {
+        Stats::Scope scope;
+        JSON::obj_to_string(big);
+        xml = XML::stringify(big);
+    }
+    assert(Stats::last().calls == 1);
+    assert(Stats::last().outputBytes == json.size() + xml.size());
+    assert(Stats::last().allocatedBytes > write.allocatedBytes);
+    assert(Stats::accumulated().calls == 3);
+#else
+    // 未开启时不收集
+    JSON::obj_to_string(big);
+    assert(Stats::last().calls == 0 && Stats::accumulated().allocations == 0);
+#endif
+}
+
 void test_file_io()
 {
     std::cout << "Testing file IO..." << std::endl;
@@ -213,6 +882,8 @@ void run_all()
 {
     test_int();
     test_double();
+    test_float();
+    test_max_decimal_places();
     test_string();
     test_vector();
     test_list();
@@ -224,6 +895,25 @@ void run_all()
     test_shared_ptr();
     test_all_stl_types();
     test_file_io();
+    test_xml_round_trip();
+    test_xml_malformed();
+    test_ini_round_trip();
+    test_ini_malformed();
+    test_diff();
+#ifdef __linux__
+    test_config_watcher();
+#endif
+    test_snapshot();
+    test_generate();
+    test_lazy_view();
+    test_extract();
+    test_value_and_sax();
+    test_field_mask();
+    test_xml_non_struct_root();
+    test_sinks();
+    test_size_hint();
+    test_ini_dotted_map_keys();
+    test_stats();
 }
 } // namespace StlTest
 